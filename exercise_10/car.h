@@ -1,80 +1,72 @@
 #pragma once
 
 #include <iostream>
-#include <string.h>
+#include "../exercise_9/number_plate.h"
+#include "../exercise_9/lifecycle_trace.h"
+#include "lifecycle_counters.h"
 
-class Car
+class Car : public lifecycle_counters::Counted<Car>
 {
 private:
-    char *number_plate = nullptr;
+    NumberPlate number_plate;
 
 public:
     Car() : Car("")
     {
-        std::cout << this << ": Car constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Car constructor called: ");
     }
 
     Car(const char *new_number_plate)
     {
-        std::cout << this << ": Car delegating constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Car delegating constructor called: ");
 
         set_number_plate(new_number_plate);
     }
 
-    Car(const Car &other)
+    Car(const Car &other) : Counted(other), number_plate(other.number_plate)
     {
-        std::cout << this << " < " << &other << ": Copy constructor called: " << std::endl;
-
-        set_number_plate(other.number_plate);
+        lifecycle_trace::event(this, &other, "Copy constructor called: ");
     }
 
-    Car(Car &&other) noexcept
+    Car(Car &&other) noexcept : Counted(std::move(other)), number_plate(std::move(other.number_plate))
     {
-        std::cout << this << " < " << &other << ": Move constructor called: " << std::endl;
-        number_plate = std::move(other.number_plate);
-        other.number_plate = nullptr;
+        lifecycle_trace::event(this, &other, "Move constructor called: ");
     }
 
     Car &operator=(const Car &other)
     {
-        std::cout << this << " < " << &other << ": Copy assignment operator called: " << std::endl;
+        lifecycle_trace::event(this, &other, "Copy assignment operator called: ");
+        Counted::operator=(other);
         if (this != &other)
         {
-            set_number_plate(other.number_plate);
+            number_plate = other.number_plate;
         }
         return *this;
     }
 
     Car &operator=(Car &&other) noexcept
     {
-        std::cout << this << " < " << &other << ": Move assignment operator called: " << std::endl;
+        lifecycle_trace::event(this, &other, "Move assignment operator called: ");
+        Counted::operator=(std::move(other));
         if (this != &other)
         {
-            delete[] number_plate;
             number_plate = std::move(other.number_plate);
-            other.number_plate = nullptr;
         }
         return *this;
     }
 
     ~Car()
     {
-        std::cout << this << ": Car destructor called: " << std::endl;
-        delete[] number_plate;
-        number_plate = nullptr;
+        lifecycle_trace::event(this, "Car destructor called: ");
     }
 
     void set_number_plate(const char *new_number_plate)
     {
-        delete[] number_plate;
-        size_t input_length = strlen(new_number_plate);
-        number_plate = new char[input_length + 1];
-        strncpy(number_plate, new_number_plate, input_length);
-        number_plate[input_length] = '\0';
+        number_plate.assign(new_number_plate);
     }
 
     const char *get_number_plate() const
     {
-        return number_plate;
+        return number_plate.c_str();
     }
 };
\ No newline at end of file
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <new>
+
+// Per-type counts of constructions, copies, moves, destructions and heap
+// allocations of the type itself (object_bytes is sizeof(T) per new T; buffers
+// an object allocates for its members, like a long plate, are not included).
+// A class opts in by deriving from lifecycle_counters::Counted<T> and forwarding
+// to the base from its own copy/move constructors and assignment operators:
+//
+//     class Car : public lifecycle_counters::Counted<Car>
+//     {
+//         Car(const Car &other) : Counted(other), ...
+//     };
+//
+//     lifecycle_counters::Snapshot before = lifecycle_counters::snapshot<Car>();
+//     ...
+//     lifecycle_counters::Snapshot delta = lifecycle_counters::snapshot<Car>() - before;
+//
+// Counters are relaxed atomics, so counting is safe from any thread. Build with
+// -DLIFECYCLE_COUNTERS=0 and the base class is empty and counts nothing.
+#ifndef LIFECYCLE_COUNTERS
+#define LIFECYCLE_COUNTERS 1
+#endif
+
+namespace lifecycle_counters
+{
+    constexpr bool ENABLED = LIFECYCLE_COUNTERS != 0;
+
+    struct Snapshot
+    {
+        size_t constructed = 0; // by any constructor other than copy/move
+        size_t copy_constructed = 0;
+        size_t move_constructed = 0;
+        size_t copy_assigned = 0;
+        size_t move_assigned = 0;
+        size_t destroyed = 0;
+        size_t allocations = 0;  // heap allocations of the type itself (new T, new T[])
+        size_t object_bytes = 0; // their size; memory the object allocates itself is not counted
+
+        size_t alive() const
+        {
+            return constructed + copy_constructed + move_constructed - destroyed;
+        }
+
+        size_t copies() const
+        {
+            return copy_constructed + copy_assigned;
+        }
+
+        size_t moves() const
+        {
+            return move_constructed + move_assigned;
+        }
+
+        Snapshot operator-(const Snapshot &other) const
+        {
+            Snapshot delta;
+            delta.constructed = constructed - other.constructed;
+            delta.copy_constructed = copy_constructed - other.copy_constructed;
+            delta.move_constructed = move_constructed - other.move_constructed;
+            delta.copy_assigned = copy_assigned - other.copy_assigned;
+            delta.move_assigned = move_assigned - other.move_assigned;
+            delta.destroyed = destroyed - other.destroyed;
+            delta.allocations = allocations - other.allocations;
+            delta.object_bytes = object_bytes - other.object_bytes;
+            return delta;
+        }
+
+        bool operator==(const Snapshot &other) const
+        {
+            return constructed == other.constructed && copy_constructed == other.copy_constructed &&
+                   move_constructed == other.move_constructed && copy_assigned == other.copy_assigned &&
+                   move_assigned == other.move_assigned && destroyed == other.destroyed &&
+                   allocations == other.allocations && object_bytes == other.object_bytes;
+        }
+
+        bool operator!=(const Snapshot &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    inline std::ostream &operator<<(std::ostream &os, const Snapshot &snapshot)
+    {
+        return os << "constructed " << snapshot.constructed
+                  << ", copy constructed " << snapshot.copy_constructed
+                  << ", move constructed " << snapshot.move_constructed
+                  << ", copy assigned " << snapshot.copy_assigned
+                  << ", move assigned " << snapshot.move_assigned
+                  << ", destroyed " << snapshot.destroyed
+                  << ", allocations " << snapshot.allocations
+                  << " (" << snapshot.object_bytes << " object bytes)";
+    }
+
+    // The live counters for one type, on their own cache line so counting one type
+    // does not slow down another.
+    struct alignas(64) Counters
+    {
+        std::atomic<size_t> constructed{0};
+        std::atomic<size_t> copy_constructed{0};
+        std::atomic<size_t> move_constructed{0};
+        std::atomic<size_t> copy_assigned{0};
+        std::atomic<size_t> move_assigned{0};
+        std::atomic<size_t> destroyed{0};
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> object_bytes{0};
+
+        static void add(std::atomic<size_t> &counter, size_t amount = 1)
+        {
+            counter.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        Snapshot load() const
+        {
+            Snapshot snapshot;
+            snapshot.constructed = constructed.load(std::memory_order_relaxed);
+            snapshot.copy_constructed = copy_constructed.load(std::memory_order_relaxed);
+            snapshot.move_constructed = move_constructed.load(std::memory_order_relaxed);
+            snapshot.copy_assigned = copy_assigned.load(std::memory_order_relaxed);
+            snapshot.move_assigned = move_assigned.load(std::memory_order_relaxed);
+            snapshot.destroyed = destroyed.load(std::memory_order_relaxed);
+            snapshot.allocations = allocations.load(std::memory_order_relaxed);
+            snapshot.object_bytes = object_bytes.load(std::memory_order_relaxed);
+            return snapshot;
+        }
+    };
+
+    template <typename T>
+    Counters &counters()
+    {
+        static Counters instance;
+        return instance;
+    }
+
+    template <typename T>
+    Snapshot snapshot()
+    {
+        return counters<T>().load();
+    }
+
+    // Empty base class (no size cost) that counts the special member calls of T.
+    template <typename T>
+    class Counted
+    {
+    protected:
+        Counted()
+        {
+            if constexpr (ENABLED)
+            {
+                Counters::add(counters<T>().constructed);
+            }
+        }
+
+        Counted(const Counted &)
+        {
+            if constexpr (ENABLED)
+            {
+                Counters::add(counters<T>().copy_constructed);
+            }
+        }
+
+        Counted(Counted &&) noexcept
+        {
+            if constexpr (ENABLED)
+            {
+                Counters::add(counters<T>().move_constructed);
+            }
+        }
+
+        Counted &operator=(const Counted &)
+        {
+            if constexpr (ENABLED)
+            {
+                Counters::add(counters<T>().copy_assigned);
+            }
+            return *this;
+        }
+
+        Counted &operator=(Counted &&) noexcept
+        {
+            if constexpr (ENABLED)
+            {
+                Counters::add(counters<T>().move_assigned);
+            }
+            return *this;
+        }
+
+        ~Counted()
+        {
+            if constexpr (ENABLED)
+            {
+                Counters::add(counters<T>().destroyed);
+            }
+        }
+
+    private:
+        static void count_allocation(size_t size)
+        {
+            if constexpr (ENABLED)
+            {
+                Counters::add(counters<T>().allocations);
+                Counters::add(counters<T>().object_bytes, size);
+            }
+        }
+
+    public:
+        // Declaring any class operator new hides every global form, so all the
+        // usual ones (nothrow, over-aligned, array) are provided and counted.
+        static void *operator new(size_t size)
+        {
+            count_allocation(size);
+            return ::operator new(size);
+        }
+
+        static void *operator new[](size_t size)
+        {
+            count_allocation(size);
+            return ::operator new[](size);
+        }
+
+        static void *operator new(size_t size, const std::nothrow_t &tag) noexcept
+        {
+            void *memory = ::operator new(size, tag);
+            if (memory != nullptr)
+            {
+                count_allocation(size);
+            }
+            return memory;
+        }
+
+        static void *operator new[](size_t size, const std::nothrow_t &tag) noexcept
+        {
+            void *memory = ::operator new[](size, tag);
+            if (memory != nullptr)
+            {
+                count_allocation(size);
+            }
+            return memory;
+        }
+
+        static void *operator new(size_t size, std::align_val_t alignment)
+        {
+            count_allocation(size);
+            return ::operator new(size, alignment);
+        }
+
+        static void *operator new[](size_t size, std::align_val_t alignment)
+        {
+            count_allocation(size);
+            return ::operator new[](size, alignment);
+        }
+
+        static void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &tag) noexcept
+        {
+            void *memory = ::operator new(size, alignment, tag);
+            if (memory != nullptr)
+            {
+                count_allocation(size);
+            }
+            return memory;
+        }
+
+        static void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &tag) noexcept
+        {
+            void *memory = ::operator new[](size, alignment, tag);
+            if (memory != nullptr)
+            {
+                count_allocation(size);
+            }
+            return memory;
+        }
+
+        static void operator delete(void *memory) noexcept
+        {
+            ::operator delete(memory);
+        }
+
+        static void operator delete[](void *memory) noexcept
+        {
+            ::operator delete[](memory);
+        }
+
+        static void operator delete(void *memory, std::align_val_t alignment) noexcept
+        {
+            ::operator delete(memory, alignment);
+        }
+
+        static void operator delete[](void *memory, std::align_val_t alignment) noexcept
+        {
+            ::operator delete[](memory, alignment);
+        }
+
+        // Called if a constructor throws after a nothrow new.
+        static void operator delete(void *memory, const std::nothrow_t &) noexcept
+        {
+            ::operator delete(memory);
+        }
+
+        static void operator delete[](void *memory, const std::nothrow_t &) noexcept
+        {
+            ::operator delete[](memory);
+        }
+
+        static void operator delete(void *memory, std::align_val_t alignment, const std::nothrow_t &) noexcept
+        {
+            ::operator delete(memory, alignment);
+        }
+
+        static void operator delete[](void *memory, std::align_val_t alignment, const std::nothrow_t &) noexcept
+        {
+            ::operator delete[](memory, alignment);
+        }
+
+        // Placement new stays available (ObjectPool constructs into its slots).
+        static void *operator new(size_t, void *place) noexcept
+        {
+            return place;
+        }
+    };
+}
@@ -0,0 +1,146 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "car.h"
+
+// Checks how many times each Car special member runs in the situations shown by
+// copy_elision.cpp and copy_assignment.cpp, so a change that turns a move into a
+// copy is caught. Exits with 1 when a count is off.
+//
+// This directory builds with -fno-elide-constructors: returning a named local
+// moves it, but initialising from a returned prvalue is still elided (C++17).
+
+static int failures = 0;
+
+static lifecycle_counters::Snapshot expected(size_t constructed, size_t copy_constructed, size_t move_constructed,
+                                             size_t copy_assigned, size_t move_assigned, size_t destroyed)
+{
+    lifecycle_counters::Snapshot snapshot;
+    snapshot.constructed = constructed;
+    snapshot.copy_constructed = copy_constructed;
+    snapshot.move_constructed = move_constructed;
+    snapshot.copy_assigned = copy_assigned;
+    snapshot.move_assigned = move_assigned;
+    snapshot.destroyed = destroyed;
+    return snapshot;
+}
+
+static void check(const char *name, bool ok, const lifecycle_counters::Snapshot &actual)
+{
+    std::cout << (ok ? "ok   " : "FAIL ") << name << ": " << actual << std::endl;
+    if (!ok)
+    {
+        ++failures;
+    }
+}
+
+// Runs scenario and compares the Car counts it produced with want.
+template <typename Scenario>
+static void expect(const char *name, const lifecycle_counters::Snapshot &want, Scenario scenario)
+{
+    lifecycle_counters::Snapshot before = lifecycle_counters::snapshot<Car>();
+    scenario();
+    lifecycle_counters::Snapshot actual = lifecycle_counters::snapshot<Car>() - before;
+    check(name, actual == want, actual);
+    if (actual != want)
+    {
+        std::cout << "     expected " << want << std::endl;
+    }
+}
+
+static Car make_car()
+{
+    Car car{};
+    return car;
+}
+
+int main()
+{
+    expect("return by value (copy_elision)", expected(1, 0, 1, 0, 0, 2), []()
+           { Car car1 = make_car(); });
+
+    expect("assign from a returned car (copy_assignment)", expected(2, 0, 1, 0, 1, 3), []()
+           {
+               Car car1;
+               car1 = make_car();
+           });
+
+    expect("copy then move", expected(1, 1, 1, 0, 0, 3), []()
+           {
+               Car original{"LH 1234"};
+               Car copy{original};
+               Car moved{std::move(copy)};
+           });
+
+    expect("swap", expected(2, 0, 1, 0, 2, 3), []()
+           {
+               Car first{"LH 1234"};
+               Car second{"LH 5678"};
+               std::swap(first, second);
+           });
+
+    {
+        lifecycle_counters::Snapshot before = lifecycle_counters::snapshot<Car>();
+        {
+            std::vector<Car> cars;
+            for (int i = 0; i < 1000; ++i)
+            {
+                cars.emplace_back("LH 1234");
+            }
+        }
+        lifecycle_counters::Snapshot actual = lifecycle_counters::snapshot<Car>() - before;
+        // Reallocation must move (noexcept move constructor), never copy.
+        check("vector growth moves", actual.constructed == 1000 && actual.copies() == 0 && actual.alive() == 0, actual);
+    }
+
+    {
+        lifecycle_counters::Snapshot want = expected(1, 0, 0, 0, 0, 1);
+        want.allocations = 1;
+        want.object_bytes = sizeof(Car);
+        expect("new / delete", want, []()
+               { delete new Car("LH 1234"); });
+    }
+
+    {
+        const int THREADS = 4;
+        const size_t PER_THREAD = 100000;
+        expect("concurrent copies", expected(THREADS, THREADS * PER_THREAD, 0, 0, 0, THREADS * (PER_THREAD + 1)), [&]()
+               {
+                   std::vector<std::thread> workers;
+                   for (int t = 0; t < THREADS; ++t)
+                   {
+                       workers.emplace_back([&]()
+                                            {
+                                                Car original{"LH 1234"};
+                                                for (size_t i = 0; i < PER_THREAD; ++i)
+                                                {
+                                                    Car copy{original};
+                                                }
+                                            });
+                   }
+                   for (std::thread &worker : workers)
+                   {
+                       worker.join();
+                   }
+               });
+    }
+
+    {
+        typedef std::chrono::steady_clock Clock;
+        const int ITERATIONS = 1000000;
+        Car original{"LH 1234"};
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < ITERATIONS; ++i)
+        {
+            Car copy{original};
+            Car moved{std::move(copy)};
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ITERATIONS;
+        std::cout << "copy + move + 2 destructions: " << ns << " ns" << std::endl;
+    }
+
+    std::cout << (failures == 0 ? "all counts as expected" : "unexpected counts") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
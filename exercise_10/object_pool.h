@@ -0,0 +1,459 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Fixed-size pool of T objects. Free slots form an intrusive lock-free stack: each
+// free slot stores the index of the next free slot, and the stack head packs the
+// top index with a version tag so a slot that is popped and pushed back between
+// another thread's read and CAS cannot corrupt the list (ABA).
+//
+// Each thread keeps a small cache of free slots per pool, so acquire() and
+// release() usually touch only memory of their own thread. The cache takes
+// slots from the shared stack and gives them back in batches, one CAS per
+// batch. The cache of an exited thread is taken back when the stack runs empty.
+//
+// When no free slot is left, acquire() falls back to the heap and counts a miss;
+// release() recognises heap objects and deletes them.
+
+namespace object_pool_detail
+{
+    // Counter written by one thread and read by others: a load and a store,
+    // not a read-modify-write.
+    inline void bump(std::atomic<size_t> &counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // One thread's free slots and statistics for one pool.
+    struct LocalCache
+    {
+        static constexpr uint32_t SIZE = 32;
+        static constexpr uint32_t BATCH = SIZE / 2;
+
+        uint64_t pool_id;
+        uint32_t free[SIZE];
+        uint32_t count = 0;
+        std::atomic<size_t> hits{0};
+        std::atomic<size_t> misses{0};
+        std::atomic<size_t> acquired{0};
+        std::atomic<size_t> released{0};
+        std::atomic<bool> orphaned{false};    // its thread has exited
+        std::atomic<bool> pool_closed{false}; // its pool has been destroyed
+
+        explicit LocalCache(uint64_t pool_id) : pool_id(pool_id) {}
+    };
+
+    // The caches of the calling thread, one per pool it has used. They are
+    // shared with the pools, which take the slots back once the thread exits.
+    class ThreadCaches
+    {
+    private:
+        std::vector<std::shared_ptr<LocalCache>> caches;
+
+    public:
+        ~ThreadCaches()
+        {
+            for (std::shared_ptr<LocalCache> &cache : caches)
+            {
+                cache->orphaned.store(true, std::memory_order_release);
+            }
+        }
+
+        template <typename Register>
+        LocalCache &find(uint64_t pool_id, Register register_cache)
+        {
+            for (std::shared_ptr<LocalCache> &cache : caches)
+            {
+                if (cache->pool_id == pool_id)
+                {
+                    return *cache;
+                }
+            }
+            caches.erase(std::remove_if(caches.begin(), caches.end(),
+                                        [](const std::shared_ptr<LocalCache> &cache)
+                                        { return cache->pool_closed.load(std::memory_order_acquire); }),
+                         caches.end());
+            caches.push_back(std::make_shared<LocalCache>(pool_id));
+            register_cache(caches.back());
+            return *caches.back();
+        }
+    };
+
+    inline ThreadCaches &thread_caches()
+    {
+        thread_local ThreadCaches caches;
+        return caches;
+    }
+
+    inline uint64_t next_pool_id()
+    {
+        static std::atomic<uint64_t> last{0};
+        return ++last;
+    }
+}
+
+template <typename T>
+class ObjectPool
+{
+public:
+    // high_water_mark counts slots taken from the shared stack (including the
+    // ones parked in thread caches) plus heap objects. It is updated once per
+    // batch, so it can exceed the real peak by up to LocalCache::SIZE per thread.
+    struct Stats
+    {
+        size_t hits;
+        size_t misses;
+        size_t in_use;
+        size_t high_water_mark;
+    };
+
+    // RAII owner of a pooled object, returns it to the pool when destroyed.
+    class Handle
+    {
+    private:
+        ObjectPool *pool = nullptr;
+        T *object = nullptr;
+
+    public:
+        Handle() = default;
+        Handle(ObjectPool *pool, T *object) : pool(pool), object(object) {}
+        Handle(const Handle &) = delete;
+        Handle &operator=(const Handle &) = delete;
+
+        Handle(Handle &&other) noexcept : pool(other.pool), object(other.object)
+        {
+            other.object = nullptr;
+        }
+
+        Handle &operator=(Handle &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                pool = other.pool;
+                object = other.object;
+                other.object = nullptr;
+            }
+            return *this;
+        }
+
+        ~Handle()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            if (object != nullptr)
+            {
+                pool->release(object);
+                object = nullptr;
+            }
+        }
+
+        T *get() const
+        {
+            return object;
+        }
+
+        T *operator->() const
+        {
+            return object;
+        }
+
+        T &operator*() const
+        {
+            return *object;
+        }
+
+        explicit operator bool() const
+        {
+            return object != nullptr;
+        }
+    };
+
+private:
+    typedef object_pool_detail::LocalCache LocalCache;
+
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    struct Slot
+    {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<uint32_t> next;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t capacity;
+    uint64_t id = object_pool_detail::next_pool_id();
+    std::atomic<uint64_t> head;
+
+    // Changed once per batch or heap allocation, not per acquire/release.
+    std::atomic<size_t> outside_stack{0}; // slots in caches or in use
+    std::atomic<size_t> heap_objects{0};
+    std::atomic<size_t> high_water_mark{0};
+
+    std::mutex registry_mutex;
+    std::vector<std::shared_ptr<LocalCache>> caches;
+    size_t retired_hits = 0; // from the caches of exited threads
+    size_t retired_misses = 0;
+    size_t retired_acquired = 0;
+    size_t retired_released = 0;
+
+    static uint64_t pack(uint32_t tag, uint32_t index)
+    {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+
+    // Pops up to wanted slots with one CAS. If the CAS succeeds the head did
+    // not change since it was read, so the links walked were not changed either.
+    uint32_t pop_free_slots(uint32_t *out, uint32_t wanted)
+    {
+        uint64_t old_head = head.load(std::memory_order_acquire);
+        while (true)
+        {
+            uint32_t count = 0;
+            uint32_t index = static_cast<uint32_t>(old_head);
+            while (index != EMPTY && count < wanted)
+            {
+                out[count++] = index;
+                index = slots[index].next.load(std::memory_order_relaxed);
+            }
+            if (count == 0)
+            {
+                return 0;
+            }
+            uint64_t new_head = pack(static_cast<uint32_t>(old_head >> 32) + 1, index);
+            if (head.compare_exchange_weak(old_head, new_head, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return count;
+            }
+        }
+    }
+
+    // Pushes count slots as one chain with one CAS.
+    void push_free_slots(const uint32_t *indices, uint32_t count)
+    {
+        for (uint32_t i = 0; i + 1 < count; ++i)
+        {
+            slots[indices[i]].next.store(indices[i + 1], std::memory_order_relaxed);
+        }
+        uint32_t last = indices[count - 1];
+        uint64_t old_head = head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            slots[last].next.store(static_cast<uint32_t>(old_head), std::memory_order_relaxed);
+            uint64_t new_head = pack(static_cast<uint32_t>(old_head >> 32) + 1, indices[0]);
+            if (head.compare_exchange_weak(old_head, new_head, std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+
+    void update_high_water_mark()
+    {
+        size_t now = outside_stack.load(std::memory_order_relaxed) + heap_objects.load(std::memory_order_relaxed);
+        size_t high = high_water_mark.load(std::memory_order_relaxed);
+        while (now > high && !high_water_mark.compare_exchange_weak(high, now, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    LocalCache &local_cache()
+    {
+        // The last pool this thread used; pool ids are never reused.
+        thread_local uint64_t last_id = 0;
+        thread_local LocalCache *last_cache = nullptr;
+        if (last_id != id)
+        {
+            last_cache = &object_pool_detail::thread_caches().find(id, [this](const std::shared_ptr<LocalCache> &cache)
+                                                                    {
+                                                                        std::lock_guard<std::mutex> lock(registry_mutex);
+                                                                        caches.push_back(cache); });
+            last_id = id;
+        }
+        return *last_cache;
+    }
+
+    // Takes back the free slots of threads that have exited.
+    bool adopt_orphans()
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        bool adopted = false;
+        for (auto it = caches.begin(); it != caches.end();)
+        {
+            LocalCache &cache = **it;
+            if (!cache.orphaned.load(std::memory_order_acquire))
+            {
+                ++it;
+                continue;
+            }
+            if (cache.count > 0)
+            {
+                push_free_slots(cache.free, cache.count);
+                outside_stack.fetch_sub(cache.count, std::memory_order_relaxed);
+                adopted = true;
+            }
+            retired_hits += cache.hits.load(std::memory_order_relaxed);
+            retired_misses += cache.misses.load(std::memory_order_relaxed);
+            retired_acquired += cache.acquired.load(std::memory_order_relaxed);
+            retired_released += cache.released.load(std::memory_order_relaxed);
+            it = caches.erase(it);
+        }
+        return adopted;
+    }
+
+    void refill(LocalCache &cache)
+    {
+        uint32_t count = pop_free_slots(cache.free, LocalCache::BATCH);
+        if (count == 0 && adopt_orphans())
+        {
+            count = pop_free_slots(cache.free, LocalCache::BATCH);
+        }
+        if (count > 0)
+        {
+            cache.count = count;
+            outside_stack.fetch_add(count, std::memory_order_relaxed);
+            update_high_water_mark();
+        }
+    }
+
+    // Gives the older half of a full cache back to the shared stack.
+    void spill(LocalCache &cache)
+    {
+        push_free_slots(cache.free, LocalCache::BATCH);
+        std::copy(cache.free + LocalCache::BATCH, cache.free + cache.count, cache.free);
+        cache.count -= LocalCache::BATCH;
+        outside_stack.fetch_sub(LocalCache::BATCH, std::memory_order_relaxed);
+    }
+
+    bool owns(const T *object) const
+    {
+        const unsigned char *address = reinterpret_cast<const unsigned char *>(object);
+        const unsigned char *first = reinterpret_cast<const unsigned char *>(slots.get());
+        return address >= first && address < first + capacity * sizeof(Slot);
+    }
+
+public:
+    explicit ObjectPool(size_t capacity) : slots(new Slot[capacity]), capacity(capacity)
+    {
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            slots[i].next.store(i + 1 < capacity ? static_cast<uint32_t>(i + 1) : EMPTY, std::memory_order_relaxed);
+        }
+        head.store(pack(0, capacity > 0 ? 0 : EMPTY), std::memory_order_release);
+    }
+
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    // Objects still in use are not destroyed.
+    ~ObjectPool()
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (std::shared_ptr<LocalCache> &cache : caches)
+        {
+            cache->pool_closed.store(true, std::memory_order_release);
+        }
+    }
+
+    template <typename... Args>
+    T *acquire(Args &&...args)
+    {
+        LocalCache &cache = local_cache();
+        if (cache.count == 0)
+        {
+            refill(cache);
+        }
+        T *object;
+        if (cache.count == 0)
+        {
+            object_pool_detail::bump(cache.misses);
+            heap_objects.fetch_add(1, std::memory_order_relaxed);
+            update_high_water_mark();
+            try
+            {
+                object = new T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                heap_objects.fetch_sub(1, std::memory_order_relaxed);
+                throw;
+            }
+        }
+        else
+        {
+            uint32_t index = cache.free[--cache.count];
+            try
+            {
+                object = new (slots[index].storage) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                cache.free[cache.count++] = index;
+                throw;
+            }
+            object_pool_detail::bump(cache.hits);
+        }
+        object_pool_detail::bump(cache.acquired);
+        return object;
+    }
+
+    // May be called from any thread, not only the one that acquired object.
+    void release(T *object)
+    {
+        LocalCache &cache = local_cache();
+        object_pool_detail::bump(cache.released);
+        if (!owns(object))
+        {
+            delete object;
+            heap_objects.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+        object->~T();
+        size_t index = (reinterpret_cast<unsigned char *>(object) - reinterpret_cast<unsigned char *>(slots.get())) / sizeof(Slot);
+        if (cache.count == LocalCache::SIZE)
+        {
+            spill(cache);
+        }
+        cache.free[cache.count++] = static_cast<uint32_t>(index);
+    }
+
+    template <typename... Args>
+    Handle make(Args &&...args)
+    {
+        return Handle(this, acquire(std::forward<Args>(args)...));
+    }
+
+    // Sums the per-thread counters; exact once the pool is quiet.
+    Stats stats()
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        Stats stats{retired_hits, retired_misses, 0, high_water_mark.load(std::memory_order_relaxed)};
+        size_t acquired = retired_acquired;
+        size_t released = retired_released;
+        for (const std::shared_ptr<LocalCache> &cache : caches)
+        {
+            stats.hits += cache->hits.load(std::memory_order_relaxed);
+            stats.misses += cache->misses.load(std::memory_order_relaxed);
+            acquired += cache->acquired.load(std::memory_order_relaxed);
+            released += cache->released.load(std::memory_order_relaxed);
+        }
+        stats.in_use = acquired > released ? acquired - released : 0;
+        return stats;
+    }
+
+    size_t get_capacity() const
+    {
+        return capacity;
+    }
+};
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "car.h"
+#include "object_pool.h"
+
+typedef std::chrono::steady_clock Clock;
+
+const int LIVE_CARS_PER_THREAD = 64;
+
+// Each thread keeps a small working set of cars and keeps replacing them.
+template <typename Acquire, typename Release>
+double churn(int threads, int operations, Acquire acquire, Release release)
+{
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]()
+                             {
+                                 Car *live[LIVE_CARS_PER_THREAD];
+                                 for (Car *&car : live)
+                                 {
+                                     car = acquire();
+                                 }
+                                 for (int i = 0; i < operations; ++i)
+                                 {
+                                     Car *&car = live[i % LIVE_CARS_PER_THREAD];
+                                     release(car);
+                                     car = acquire();
+                                 }
+                                 for (Car *car : live)
+                                 {
+                                     release(car);
+                                 } });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    int operations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    int max_threads = argc > 2 ? std::atoi(argv[2]) : 8;
+
+    std::cout << operations << " replacements per thread" << std::endl;
+
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double heap_ms = churn(
+            threads, operations,
+            []()
+            { return new Car("LH 1234"); },
+            [](Car *car)
+            { delete car; });
+
+        ObjectPool<Car> pool(threads * LIVE_CARS_PER_THREAD);
+        double pool_ms = churn(
+            threads, operations,
+            [&pool]()
+            { return pool.acquire("LH 1234"); },
+            [&pool](Car *car)
+            { pool.release(car); });
+
+        ObjectPool<Car>::Stats stats = pool.stats();
+
+        std::cout << threads << " threads: new/delete " << heap_ms << " ms, pool " << pool_ms << " ms"
+                  << " (hits " << stats.hits << ", misses " << stats.misses
+                  << ", high-water " << stats.high_water_mark << ")" << std::endl;
+    }
+
+    return 0;
+}
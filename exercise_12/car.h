@@ -1,41 +1,42 @@
 #pragma once
 
 #include <iostream>
-#include <string>
-#include <memory>
+#include <string_view>
+#include "string_interner.h"
+#include "../exercise_9/lifecycle_trace.h"
 
 class Car
 {
 private:
-    std::shared_ptr<std::string> number_plate;
+    Symbol number_plate;
 
 public:
     Car() : Car("")
     {
-        std::cout << this << ": Car constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Car constructor called: ");
     }
 
     Car(const char *new_number_plate)
     {
-        std::cout << this << ": Car delegating constructor called: " << std::endl;
-        number_plate = std::make_shared<std::string>(new_number_plate);
+        lifecycle_trace::event(this, "Car delegating constructor called: ");
+        number_plate = Symbol::intern(new_number_plate);
     }
 
     Car(const Car &other)
     {
-        std::cout << this << " < " << &other << ": Copy constructor called: " << std::endl;
+        lifecycle_trace::event(this, &other, "Copy constructor called: ");
         number_plate = other.number_plate;
     }
 
     Car(Car &&other) noexcept
     {
-        std::cout << this << " < " << &other << ": Move constructor called: " << std::endl;
-        number_plate = std::move(other.number_plate);
+        lifecycle_trace::event(this, &other, "Move constructor called: ");
+        number_plate = other.number_plate;
     }
 
     Car &operator=(const Car &other)
     {
-        std::cout << this << " < " << &other << ": Copy assignment operator called: " << std::endl;
+        lifecycle_trace::event(this, &other, "Copy assignment operator called: ");
         if (this != &other)
         {
             number_plate = other.number_plate;
@@ -45,21 +46,21 @@ public:
 
     Car &operator=(Car &&other) noexcept
     {
-        std::cout << this << " < " << &other << ": Move assignment operator called: " << std::endl;
+        lifecycle_trace::event(this, &other, "Move assignment operator called: ");
         if (this != &other)
         {
-            number_plate = std::move(other.number_plate);
+            number_plate = other.number_plate;
         }
         return *this;
     }
 
     ~Car()
     {
-        std::cout << this << ": Car destructor called: " << std::endl;
+        lifecycle_trace::event(this, "Car destructor called: ");
     }
 
-    const std::string &get_number_plate() const
+    std::string_view get_number_plate() const
     {
-        return *number_plate;
+        return number_plate.view();
     }
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "car.h"
+
+int main()
+{
+    const char *plates[] = {"LH 100", "LH 200", "LH 300"};
+
+    // Four threads build cars with the same three plates.
+    std::vector<std::vector<Car>> fleets(4);
+    std::vector<std::thread> threads;
+    for (auto &fleet : fleets)
+    {
+        threads.emplace_back([&fleet, &plates]()
+                             {
+                                 for (const char *plate : plates)
+                                 {
+                                     fleet.emplace_back(plate);
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    // Every car shares one copy of its plate string.
+    for (const auto &fleet : fleets)
+    {
+        std::cout << "plate " << fleet[0].get_number_plate() << " stored at "
+                  << static_cast<const void *>(fleet[0].get_number_plate().data()) << std::endl;
+    }
+    std::cout << "Distinct strings interned: " << StringInterner::global().size() << std::endl;
+
+    return 0;
+}
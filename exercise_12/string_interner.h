@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Thread-safe string pool. Every distinct string is stored once and identified by
+// a 32-bit id; id -> string lookups are lock-free array reads, and string -> id
+// lookups of already interned strings only take a shared lock.
+// Id 0 is always the empty string.
+class StringInterner
+{
+private:
+    static constexpr uint32_t BLOCK_BITS = 16;
+    static constexpr uint32_t BLOCK_SIZE = 1u << BLOCK_BITS;
+    static constexpr uint32_t MAX_BLOCKS = 1u << (32 - BLOCK_BITS);
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    // Entries never move once published, so readers need no lock.
+    std::unique_ptr<std::atomic<std::string_view *>[]> blocks;
+    std::atomic<uint32_t> count{0};
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string_view, uint32_t> ids;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    std::vector<std::unique_ptr<char[]>> large_strings;
+    size_t chunk_used = CHUNK_SIZE;
+
+    std::string_view store(std::string_view text)
+    {
+        if (text.empty())
+        {
+            return std::string_view();
+        }
+
+        char *target;
+        if (text.size() > CHUNK_SIZE / 4)
+        {
+            // Large strings get their own allocation so the current chunk keeps filling.
+            large_strings.emplace_back(new char[text.size()]);
+            target = large_strings.back().get();
+        }
+        else
+        {
+            if (text.size() > CHUNK_SIZE - chunk_used)
+            {
+                chunks.emplace_back(new char[CHUNK_SIZE]);
+                chunk_used = 0;
+            }
+            target = chunks.back().get() + chunk_used;
+            chunk_used += text.size();
+        }
+        std::memcpy(target, text.data(), text.size());
+        return std::string_view(target, text.size());
+    }
+
+public:
+    StringInterner() : blocks(new std::atomic<std::string_view *>[MAX_BLOCKS])
+    {
+        for (uint32_t i = 0; i < MAX_BLOCKS; ++i)
+        {
+            blocks[i].store(nullptr, std::memory_order_relaxed);
+        }
+        intern(std::string_view());
+    }
+
+    StringInterner(const StringInterner &) = delete;
+    StringInterner &operator=(const StringInterner &) = delete;
+
+    ~StringInterner()
+    {
+        for (uint32_t i = 0; i < MAX_BLOCKS; ++i)
+        {
+            delete[] blocks[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t intern(std::string_view text)
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto found = ids.find(text);
+            if (found != ids.end())
+            {
+                return found->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto found = ids.find(text);
+        if (found != ids.end())
+        {
+            return found->second;
+        }
+
+        uint32_t id = count.load(std::memory_order_relaxed);
+        if (id == UINT32_MAX)
+        {
+            throw std::length_error("StringInterner: out of ids");
+        }
+
+        std::atomic<std::string_view *> &block = blocks[id >> BLOCK_BITS];
+        std::string_view *entries = block.load(std::memory_order_relaxed);
+        if (entries == nullptr)
+        {
+            entries = new std::string_view[BLOCK_SIZE];
+            block.store(entries, std::memory_order_release);
+        }
+
+        std::string_view stored = store(text);
+        entries[id & (BLOCK_SIZE - 1)] = stored;
+        ids.emplace(stored, id);
+        count.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    // O(1) and lock-free; id must have been returned by intern().
+    std::string_view lookup(uint32_t id) const
+    {
+        return blocks[id >> BLOCK_BITS].load(std::memory_order_acquire)[id & (BLOCK_SIZE - 1)];
+    }
+
+    size_t size() const
+    {
+        return count.load(std::memory_order_acquire);
+    }
+
+    static StringInterner &global()
+    {
+        static StringInterner interner;
+        return interner;
+    }
+};
+
+// Compact handle to a string in the global interner. Copying a Symbol copies one
+// 32-bit integer; equal strings always have equal symbols.
+class Symbol
+{
+private:
+    uint32_t id = 0;
+
+    explicit Symbol(uint32_t id) : id(id) {}
+
+public:
+    Symbol() = default;
+
+    static Symbol intern(std::string_view text)
+    {
+        return Symbol(StringInterner::global().intern(text));
+    }
+
+    static Symbol from_id(uint32_t id)
+    {
+        return Symbol(id);
+    }
+
+    uint32_t get_id() const
+    {
+        return id;
+    }
+
+    std::string_view view() const
+    {
+        return StringInterner::global().lookup(id);
+    }
+
+    friend bool operator==(Symbol a, Symbol b)
+    {
+        return a.id == b.id;
+    }
+
+    friend bool operator!=(Symbol a, Symbol b)
+    {
+        return a.id != b.id;
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, Symbol symbol)
+    {
+        return os << symbol.view();
+    }
+};
+
+namespace std
+{
+    template <>
+    struct hash<Symbol>
+    {
+        size_t operator()(Symbol symbol) const noexcept
+        {
+            return hash<uint32_t>()(symbol.get_id());
+        }
+    };
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+// Minimal stand-in for google-benchmark: repeats a function until it has run for
+// at least MIN_TIME and prints wall and CPU time per iteration in the same layout.
+namespace bench
+{
+    const double MIN_TIME = 0.5; // seconds
+
+    // Keeps the optimizer from discarding a computed value.
+    template <typename T>
+    void do_not_optimize(const T &value)
+    {
+#if defined(__GNUC__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static const void *volatile sink;
+        sink = &value;
+#endif
+    }
+
+    // Formats "name/arg" like google-benchmark's Arg().
+    inline std::string with_arg(const std::string &name, size_t arg)
+    {
+        char buffer[128];
+        std::snprintf(buffer, sizeof(buffer), "%s/%zu", name.c_str(), arg);
+        return buffer;
+    }
+
+    inline void print_header()
+    {
+        std::printf("%-40s %15s %15s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+        std::printf("%s\n", std::string(85, '-').c_str());
+    }
+
+    template <typename Function>
+    void run(const std::string &name, Function function)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        long iterations = 1;
+        while (true)
+        {
+            Clock::time_point wall_start = Clock::now();
+            std::clock_t cpu_start = std::clock();
+            for (long i = 0; i < iterations; ++i)
+            {
+                function();
+            }
+            double wall = std::chrono::duration<double>(Clock::now() - wall_start).count();
+            double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+            if (wall >= MIN_TIME || iterations >= 1000000000L)
+            {
+                std::printf("%-40s %12.0f ns %12.0f ns %12ld\n", name.c_str(),
+                            wall * 1e9 / iterations, cpu * 1e9 / iterations, iterations);
+                return;
+            }
+            iterations = wall > 0 ? static_cast<long>(iterations * (MIN_TIME * 1.4 / wall)) + 1 : iterations * 10;
+        }
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "vehicle.h"
 #include "motorized.h"
+#include "../exercise_9/lifecycle_trace.h"
 
 class Car : public Vehicle, public Motorized
 {
@@ -13,12 +14,12 @@ private:
 public:
     Car()
     {
-        std::cout << this << ": Car constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Car constructor called: ");
     }
 
     ~Car()
     {
-        std::cout << this << ": Car destructor called: " << std::endl;
+        lifecycle_trace::event(this, "Car destructor called: ");
     }
 
     void print() override
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include "../exercise_9/lifecycle_trace.h"
 
 class Engine
 {
@@ -10,11 +11,11 @@ private:
 public:
     Engine()
     {
-        std::cout << this << ": Engine constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Engine constructor called: ");
     }
     ~Engine()
     {
-        std::cout << this << ": Engine destructor called: " << std::endl;
+        lifecycle_trace::event(this, "Engine destructor called: ");
     }
 
     friend std::ostream &operator<<(std::ostream &os, const Engine &engine)
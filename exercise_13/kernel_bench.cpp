@@ -0,0 +1,151 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "benchmark.h"
+#include "shape.h"
+#include "shape_kernels.h"
+
+using shape_kernels::Isa;
+
+int main(int argc, char *argv[])
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (1u << 20);
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> size(0.5, 10.0);
+
+    std::vector<Circle> circles;
+    std::vector<Rectangle> rectangles;
+    circles.reserve(count);
+    rectangles.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        circles.emplace_back(size(random));
+        rectangles.emplace_back(size(random), size(random));
+    }
+
+    // The same shapes as columns (structure of arrays).
+    std::vector<double> radii(count);
+    std::vector<double> widths(count);
+    std::vector<double> heights(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        radii[i] = circles[i].get_radius();
+        widths[i] = rectangles[i].get_width();
+        heights[i] = rectangles[i].get_height();
+    }
+
+    // Every kernel must match the member functions bit for bit, and every
+    // total must match the scalar total.
+    std::vector<double> expected_circles(count);
+    std::vector<double> expected_rectangles(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        expected_circles[i] = circles[i].area();
+        expected_rectangles[i] = rectangles[i].area();
+    }
+    std::vector<double> actual(count);
+    auto same_areas = [&](const std::vector<double> &expected)
+    {
+        return std::memcmp(expected.data(), actual.data(), count * sizeof(double)) == 0;
+    };
+    auto same_total = [](double total, double reference)
+    {
+        return std::memcmp(&total, &reference, sizeof(double)) == 0;
+    };
+
+    Isa best = shape_kernels::detect_isa();
+    shape_kernels::set_isa(Isa::Scalar);
+    double circle_total = shape_kernels::total_area(circles);
+    double rectangle_total = shape_kernels::total_area(rectangles);
+    bool identical = true;
+    for (Isa isa : {Isa::Scalar, Isa::SSE2, Isa::AVX2})
+    {
+        if (isa > best)
+        {
+            continue;
+        }
+        shape_kernels::set_isa(isa);
+        bool same = true;
+        shape_kernels::areas(circles, actual);
+        same = same && same_areas(expected_circles);
+        shape_kernels::circle_areas(radii, actual);
+        same = same && same_areas(expected_circles);
+        shape_kernels::areas(rectangles, actual);
+        same = same && same_areas(expected_rectangles);
+        shape_kernels::rectangle_areas(widths, heights, actual);
+        same = same && same_areas(expected_rectangles);
+        same = same && same_total(shape_kernels::total_area(circles), circle_total) &&
+               same_total(shape_kernels::total_circle_area(radii), circle_total) &&
+               same_total(shape_kernels::total_area(rectangles), rectangle_total) &&
+               same_total(shape_kernels::total_rectangle_area(widths, heights), rectangle_total);
+        std::cout << shape_kernels::isa_name(isa) << ": " << (same ? "bit-identical" : "MISMATCH") << std::endl;
+        identical = identical && same;
+    }
+    if (!identical)
+    {
+        return 1;
+    }
+
+    std::vector<const Shape *> shapes;
+    shapes.reserve(count);
+    for (const Circle &circle : circles)
+    {
+        shapes.push_back(&circle);
+    }
+
+    bench::print_header();
+
+    bench::run(bench::with_arg("BM_VirtualCircleArea", count), [&]()
+               {
+                   for (size_t i = 0; i < count; ++i)
+                   {
+                       actual[i] = shapes[i]->area();
+                   }
+                   bench::do_not_optimize(actual); });
+
+    for (Isa isa : {Isa::Scalar, Isa::SSE2, Isa::AVX2})
+    {
+        if (isa > best)
+        {
+            continue;
+        }
+        shape_kernels::set_isa(isa);
+        std::string name = shape_kernels::isa_name(isa);
+
+        bench::run(bench::with_arg("BM_CircleAreas_" + name, count), [&]()
+                   {
+                       shape_kernels::areas(circles, actual);
+                       bench::do_not_optimize(actual); });
+
+        bench::run(bench::with_arg("BM_RectangleAreas_" + name, count), [&]()
+                   {
+                       shape_kernels::areas(rectangles, actual);
+                       bench::do_not_optimize(actual); });
+
+        bench::run(bench::with_arg("BM_TotalCircleArea_" + name, count), [&]()
+                   {
+                       double total = shape_kernels::total_area(circles);
+                       bench::do_not_optimize(total); });
+
+        bench::run(bench::with_arg("BM_CircleColumnAreas_" + name, count), [&]()
+                   {
+                       shape_kernels::circle_areas(radii, actual);
+                       bench::do_not_optimize(actual); });
+
+        bench::run(bench::with_arg("BM_RectangleColumnAreas_" + name, count), [&]()
+                   {
+                       shape_kernels::rectangle_areas(widths, heights, actual);
+                       bench::do_not_optimize(actual); });
+
+        bench::run(bench::with_arg("BM_TotalCircleColumnArea_" + name, count), [&]()
+                   {
+                       double total = shape_kernels::total_circle_area(radii);
+                       bench::do_not_optimize(total); });
+    }
+
+    return 0;
+}
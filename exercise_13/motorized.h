@@ -1,6 +1,7 @@
 #pragma once
 #include <iostream>
 #include "engine.h"
+#include "../exercise_9/lifecycle_trace.h"
 
 class Motorized
 {
@@ -10,11 +11,11 @@ private:
 public:
     Motorized()
     {
-        std::cout << this << ": Motorized constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Motorized constructor called: ");
     }
     ~Motorized()
     {
-        std::cout << this << ": Motorized destructor called: " << std::endl;
+        lifecycle_trace::event(this, "Motorized destructor called: ");
     }
 
     void print()
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Heterogeneous collection that keeps one contiguous vector per concrete type.
+// for_each visits a whole bucket before moving to the next one, so the callable
+// is invoked with the concrete type and every call inside a bucket loop is a
+// direct (usually inlined) call instead of a virtual dispatch through a base pointer.
+//
+//     PolyCollection<Circle, Rectangle> shapes;
+//     shapes.emplace<Circle>(5.0);
+//     shapes.for_each([&](const auto &shape) { total += shape.area(); });
+template <typename... Ts>
+class PolyCollection
+{
+private:
+    std::tuple<std::vector<Ts>...> buckets;
+
+    template <typename T, typename... Us>
+    struct index_of;
+
+    template <typename T, typename... Us>
+    struct index_of<T, T, Us...> : std::integral_constant<size_t, 0>
+    {
+    };
+
+    template <typename T, typename U, typename... Us>
+    struct index_of<T, U, Us...> : std::integral_constant<size_t, 1 + index_of<T, Us...>::value>
+    {
+    };
+
+public:
+    template <typename T>
+    std::vector<T> &bucket()
+    {
+        return std::get<index_of<T, Ts...>::value>(buckets);
+    }
+
+    template <typename T>
+    const std::vector<T> &bucket() const
+    {
+        return std::get<index_of<T, Ts...>::value>(buckets);
+    }
+
+    template <typename T>
+    void add(T value)
+    {
+        bucket<T>().push_back(std::move(value));
+    }
+
+    template <typename T, typename... Args>
+    T &emplace(Args &&...args)
+    {
+        return bucket<T>().emplace_back(std::forward<Args>(args)...);
+    }
+
+    template <typename Function>
+    void for_each(Function &&function)
+    {
+        (for_each_in(bucket<Ts>(), function), ...);
+    }
+
+    template <typename Function>
+    void for_each(Function &&function) const
+    {
+        (for_each_in(bucket<Ts>(), function), ...);
+    }
+
+    void reserve(size_t count_per_type)
+    {
+        (bucket<Ts>().reserve(count_per_type), ...);
+    }
+
+    void clear()
+    {
+        (bucket<Ts>().clear(), ...);
+    }
+
+    size_t size() const
+    {
+        return (bucket<Ts>().size() + ... + 0);
+    }
+
+private:
+    template <typename T, typename Function>
+    static void for_each_in(std::vector<T> &items, Function &function)
+    {
+        for (T &item : items)
+        {
+            function(item);
+        }
+    }
+
+    template <typename T, typename Function>
+    static void for_each_in(const std::vector<T> &items, Function &function)
+    {
+        for (const T &item : items)
+        {
+            function(item);
+        }
+    }
+};
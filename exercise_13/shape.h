@@ -0,0 +1,70 @@
+#pragma once
+
+#include <iostream>
+
+// Abstract base class
+class Shape
+{
+public:
+    // Pure virtual function (makes the class abstract)
+    virtual double area() const = 0;
+
+    // Virtual destructor
+    virtual ~Shape() {}
+
+    // Non-virtual function
+    void printArea() const
+    {
+        std::cout << "Area: " << area() << std::endl;
+    }
+};
+
+// Derived class, final so calls through a Circle reference need no virtual dispatch
+class Circle final : public Shape
+{
+private:
+    double radius;
+
+public:
+    static constexpr double PI = 3.14159;
+
+    Circle(double r) : radius(r) {}
+
+    // Implementation of the pure virtual function
+    double area() const override
+    {
+        return PI * radius * radius;
+    }
+
+    double get_radius() const
+    {
+        return radius;
+    }
+};
+
+// Another derived class
+class Rectangle final : public Shape
+{
+private:
+    double width;
+    double height;
+
+public:
+    Rectangle(double w, double h) : width(w), height(h) {}
+
+    // Implementation of the pure virtual function
+    double area() const override
+    {
+        return width * height;
+    }
+
+    double get_width() const
+    {
+        return width;
+    }
+
+    double get_height() const
+    {
+        return height;
+    }
+};
@@ -0,0 +1,61 @@
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "benchmark.h"
+#include "poly_collection.h"
+#include "shape.h"
+
+int main(int argc, char *argv[])
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (1u << 20);
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> size(0.5, 10.0);
+    std::bernoulli_distribution is_circle(0.5);
+
+    // Pointer-array path: mixed heap objects visited through Shape *.
+    std::vector<std::unique_ptr<Shape>> pointers;
+    // Bucketed path: the same shapes grouped by concrete type.
+    PolyCollection<Circle, Rectangle> buckets;
+
+    pointers.reserve(count);
+    buckets.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (is_circle(random))
+        {
+            double radius = size(random);
+            pointers.emplace_back(new Circle(radius));
+            buckets.emplace<Circle>(radius);
+        }
+        else
+        {
+            double width = size(random);
+            double height = size(random);
+            pointers.emplace_back(new Rectangle(width, height));
+            buckets.emplace<Rectangle>(width, height);
+        }
+    }
+
+    bench::print_header();
+
+    bench::run(bench::with_arg("BM_VirtualArea", count), [&]()
+               {
+                   double total = 0;
+                   for (const auto &shape : pointers)
+                   {
+                       total += shape->area();
+                   }
+                   bench::do_not_optimize(total); });
+
+    bench::run(bench::with_arg("BM_BucketedArea", count), [&]()
+               {
+                   double total = 0;
+                   buckets.for_each([&total](const auto &shape)
+                                    { total += shape.area(); });
+                   bench::do_not_optimize(total); });
+
+    return 0;
+}
@@ -0,0 +1,532 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include "shape.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHAPE_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// Batch area kernels for Circle and Rectangle.
+//
+// There are two layouts. areas(circles) / total_area(circles) read Circle and
+// Rectangle objects: each value is gathered from an object that also holds a
+// vptr, so the vector kernels are no faster than the scalar loop, which these
+// use unless set_isa() says otherwise. The column kernels (circle_areas(radii),
+// rectangle_areas(widths, heights), ...) read plain arrays of doubles
+// (structure of arrays) with contiguous vector loads and pick the best ISA;
+// keep the shapes in columns to get the SIMD speedup.
+//
+// areas() computes exactly the same expression as Circle::area() /
+// Rectangle::area() in the same order (pi * r * r, w * h), so every ISA produces
+// results that are bit-for-bit identical to the scalar member functions.
+//
+// total_area() always sums in four interleaved lanes (element i goes to lane
+// i % 4, lanes are combined as (l0 + l1) + (l2 + l3), then the tail is added),
+// so scalar, SSE2 and AVX2 return bit-identical totals. Compared with a plain
+// left-to-right loop the result only differs by rounding: both orders are
+// within (n - 1) * 2^-53 * sum(areas) of the exact sum.
+namespace shape_kernels
+{
+    enum class Isa
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    inline Isa detect_isa()
+    {
+#if SHAPE_KERNELS_X86
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return Isa::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return Isa::SSE2;
+        }
+#endif
+        return Isa::Scalar;
+    }
+
+    // The column kernels use the best ISA by default.
+    inline Isa &selected_isa()
+    {
+        static Isa isa = detect_isa();
+        return isa;
+    }
+
+    // The object kernels default to the scalar loop: their gathers are slower.
+    inline Isa &selected_object_isa()
+    {
+        static Isa isa = Isa::Scalar;
+        return isa;
+    }
+
+    // Forces a kernel for both layouts, e.g. to compare results; falls back to
+    // the best supported one.
+    inline void set_isa(Isa isa)
+    {
+        selected_isa() = isa > detect_isa() ? detect_isa() : isa;
+        selected_object_isa() = selected_isa();
+    }
+
+    inline const char *isa_name(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::AVX2:
+            return "AVX2";
+        case Isa::SSE2:
+            return "SSE2";
+        default:
+            return "scalar";
+        }
+    }
+
+    namespace detail
+    {
+        const double PI = Circle::PI;
+
+        inline double circle_area(const Circle &circle)
+        {
+            double radius = circle.get_radius();
+            return PI * radius * radius;
+        }
+
+        inline double rectangle_area(const Rectangle &rectangle)
+        {
+            return rectangle.get_width() * rectangle.get_height();
+        }
+
+        inline double combine_lanes(const double lanes[4])
+        {
+            return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        }
+
+        // Scalar
+
+        inline void circle_areas_scalar(const Circle *circles, double *out, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = circle_area(circles[i]);
+            }
+        }
+
+        inline void rectangle_areas_scalar(const Rectangle *rectangles, double *out, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = rectangle_area(rectangles[i]);
+            }
+        }
+
+        template <typename AreaOf>
+        double total_scalar(size_t count, AreaOf area_of)
+        {
+            double lanes[4] = {0, 0, 0, 0};
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                lanes[0] += area_of(i);
+                lanes[1] += area_of(i + 1);
+                lanes[2] += area_of(i + 2);
+                lanes[3] += area_of(i + 3);
+            }
+            double total = combine_lanes(lanes);
+            for (; i < count; ++i)
+            {
+                total += area_of(i);
+            }
+            return total;
+        }
+
+#if SHAPE_KERNELS_X86
+        // SSE2: two vectors of two lanes each hold the four lanes.
+
+        __attribute__((target("sse2"))) inline __m128d circle_pair_sse2(const Circle *c)
+        {
+            __m128d radius = _mm_set_pd(c[1].get_radius(), c[0].get_radius());
+            return _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(PI), radius), radius);
+        }
+
+        __attribute__((target("sse2"))) inline __m128d rectangle_pair_sse2(const Rectangle *r)
+        {
+            __m128d width = _mm_set_pd(r[1].get_width(), r[0].get_width());
+            __m128d height = _mm_set_pd(r[1].get_height(), r[0].get_height());
+            return _mm_mul_pd(width, height);
+        }
+
+        __attribute__((target("sse2"))) inline void circle_areas_sse2(const Circle *circles, double *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                _mm_storeu_pd(out + i, circle_pair_sse2(circles + i));
+            }
+            circle_areas_scalar(circles + i, out + i, count - i);
+        }
+
+        __attribute__((target("sse2"))) inline void rectangle_areas_sse2(const Rectangle *rectangles, double *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                _mm_storeu_pd(out + i, rectangle_pair_sse2(rectangles + i));
+            }
+            rectangle_areas_scalar(rectangles + i, out + i, count - i);
+        }
+
+        template <typename T, __m128d (*Pair)(const T *), double (*AreaOf)(const T &)>
+        __attribute__((target("sse2"))) double total_sse2(const T *shapes, size_t count)
+        {
+            __m128d low = _mm_setzero_pd();
+            __m128d high = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                low = _mm_add_pd(low, Pair(shapes + i));
+                high = _mm_add_pd(high, Pair(shapes + i + 2));
+            }
+            double lanes[4];
+            _mm_storeu_pd(lanes, low);
+            _mm_storeu_pd(lanes + 2, high);
+            double total = combine_lanes(lanes);
+            for (; i < count; ++i)
+            {
+                total += AreaOf(shapes[i]);
+            }
+            return total;
+        }
+
+        // AVX2: one vector holds the four lanes.
+
+        __attribute__((target("avx2"))) inline __m256d circle_quad_avx2(const Circle *c)
+        {
+            __m256d radius = _mm256_set_pd(c[3].get_radius(), c[2].get_radius(), c[1].get_radius(), c[0].get_radius());
+            return _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(PI), radius), radius);
+        }
+
+        __attribute__((target("avx2"))) inline __m256d rectangle_quad_avx2(const Rectangle *r)
+        {
+            __m256d width = _mm256_set_pd(r[3].get_width(), r[2].get_width(), r[1].get_width(), r[0].get_width());
+            __m256d height = _mm256_set_pd(r[3].get_height(), r[2].get_height(), r[1].get_height(), r[0].get_height());
+            return _mm256_mul_pd(width, height);
+        }
+
+        __attribute__((target("avx2"))) inline void circle_areas_avx2(const Circle *circles, double *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm256_storeu_pd(out + i, circle_quad_avx2(circles + i));
+            }
+            circle_areas_scalar(circles + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx2"))) inline void rectangle_areas_avx2(const Rectangle *rectangles, double *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm256_storeu_pd(out + i, rectangle_quad_avx2(rectangles + i));
+            }
+            rectangle_areas_scalar(rectangles + i, out + i, count - i);
+        }
+
+        template <typename T, __m256d (*Quad)(const T *), double (*AreaOf)(const T &)>
+        __attribute__((target("avx2"))) double total_avx2(const T *shapes, size_t count)
+        {
+            __m256d sum = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                sum = _mm256_add_pd(sum, Quad(shapes + i));
+            }
+            double lanes[4];
+            _mm256_storeu_pd(lanes, sum);
+            double total = combine_lanes(lanes);
+            for (; i < count; ++i)
+            {
+                total += AreaOf(shapes[i]);
+            }
+            return total;
+        }
+
+        // Columns (structure of arrays): contiguous loads instead of gathers.
+
+        struct RadiusColumn
+        {
+            const double *radii;
+
+            double area(size_t i) const
+            {
+                return PI * radii[i] * radii[i];
+            }
+
+            __attribute__((target("sse2"))) __m128d pair_sse2(size_t i) const
+            {
+                __m128d radius = _mm_loadu_pd(radii + i);
+                return _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(PI), radius), radius);
+            }
+
+            __attribute__((target("avx2"))) __m256d quad_avx2(size_t i) const
+            {
+                __m256d radius = _mm256_loadu_pd(radii + i);
+                return _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(PI), radius), radius);
+            }
+        };
+
+        struct RectangleColumns
+        {
+            const double *widths;
+            const double *heights;
+
+            double area(size_t i) const
+            {
+                return widths[i] * heights[i];
+            }
+
+            __attribute__((target("sse2"))) __m128d pair_sse2(size_t i) const
+            {
+                return _mm_mul_pd(_mm_loadu_pd(widths + i), _mm_loadu_pd(heights + i));
+            }
+
+            __attribute__((target("avx2"))) __m256d quad_avx2(size_t i) const
+            {
+                return _mm256_mul_pd(_mm256_loadu_pd(widths + i), _mm256_loadu_pd(heights + i));
+            }
+        };
+
+        template <typename Columns>
+        __attribute__((target("sse2"))) void column_areas_sse2(const Columns &columns, double *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                _mm_storeu_pd(out + i, columns.pair_sse2(i));
+            }
+            for (; i < count; ++i)
+            {
+                out[i] = columns.area(i);
+            }
+        }
+
+        template <typename Columns>
+        __attribute__((target("avx2"))) void column_areas_avx2(const Columns &columns, double *out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm256_storeu_pd(out + i, columns.quad_avx2(i));
+            }
+            for (; i < count; ++i)
+            {
+                out[i] = columns.area(i);
+            }
+        }
+
+        template <typename Columns>
+        __attribute__((target("sse2"))) double column_total_sse2(const Columns &columns, size_t count)
+        {
+            __m128d low = _mm_setzero_pd();
+            __m128d high = _mm_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                low = _mm_add_pd(low, columns.pair_sse2(i));
+                high = _mm_add_pd(high, columns.pair_sse2(i + 2));
+            }
+            double lanes[4];
+            _mm_storeu_pd(lanes, low);
+            _mm_storeu_pd(lanes + 2, high);
+            double total = combine_lanes(lanes);
+            for (; i < count; ++i)
+            {
+                total += columns.area(i);
+            }
+            return total;
+        }
+
+        template <typename Columns>
+        __attribute__((target("avx2"))) double column_total_avx2(const Columns &columns, size_t count)
+        {
+            __m256d sum = _mm256_setzero_pd();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                sum = _mm256_add_pd(sum, columns.quad_avx2(i));
+            }
+            double lanes[4];
+            _mm256_storeu_pd(lanes, sum);
+            double total = combine_lanes(lanes);
+            for (; i < count; ++i)
+            {
+                total += columns.area(i);
+            }
+            return total;
+        }
+#endif
+    }
+
+    inline void areas(std::span<const Circle> circles, std::span<double> out)
+    {
+        if (out.size() < circles.size())
+        {
+            throw std::invalid_argument("areas: output span is smaller than input");
+        }
+        switch (selected_object_isa())
+        {
+#if SHAPE_KERNELS_X86
+        case Isa::AVX2:
+            return detail::circle_areas_avx2(circles.data(), out.data(), circles.size());
+        case Isa::SSE2:
+            return detail::circle_areas_sse2(circles.data(), out.data(), circles.size());
+#endif
+        default:
+            return detail::circle_areas_scalar(circles.data(), out.data(), circles.size());
+        }
+    }
+
+    inline void areas(std::span<const Rectangle> rectangles, std::span<double> out)
+    {
+        if (out.size() < rectangles.size())
+        {
+            throw std::invalid_argument("areas: output span is smaller than input");
+        }
+        switch (selected_object_isa())
+        {
+#if SHAPE_KERNELS_X86
+        case Isa::AVX2:
+            return detail::rectangle_areas_avx2(rectangles.data(), out.data(), rectangles.size());
+        case Isa::SSE2:
+            return detail::rectangle_areas_sse2(rectangles.data(), out.data(), rectangles.size());
+#endif
+        default:
+            return detail::rectangle_areas_scalar(rectangles.data(), out.data(), rectangles.size());
+        }
+    }
+
+    inline double total_area(std::span<const Circle> circles)
+    {
+        switch (selected_object_isa())
+        {
+#if SHAPE_KERNELS_X86
+        case Isa::AVX2:
+            return detail::total_avx2<Circle, detail::circle_quad_avx2, detail::circle_area>(circles.data(), circles.size());
+        case Isa::SSE2:
+            return detail::total_sse2<Circle, detail::circle_pair_sse2, detail::circle_area>(circles.data(), circles.size());
+#endif
+        default:
+            return detail::total_scalar(circles.size(), [&circles](size_t i)
+                                        { return detail::circle_area(circles[i]); });
+        }
+    }
+
+    inline double total_area(std::span<const Rectangle> rectangles)
+    {
+        switch (selected_object_isa())
+        {
+#if SHAPE_KERNELS_X86
+        case Isa::AVX2:
+            return detail::total_avx2<Rectangle, detail::rectangle_quad_avx2, detail::rectangle_area>(rectangles.data(), rectangles.size());
+        case Isa::SSE2:
+            return detail::total_sse2<Rectangle, detail::rectangle_pair_sse2, detail::rectangle_area>(rectangles.data(), rectangles.size());
+#endif
+        default:
+            return detail::total_scalar(rectangles.size(), [&rectangles](size_t i)
+                                        { return detail::rectangle_area(rectangles[i]); });
+        }
+    }
+
+    // Column kernels: the same results as the object kernels, read from arrays.
+
+    inline void circle_areas(std::span<const double> radii, std::span<double> out)
+    {
+        if (out.size() < radii.size())
+        {
+            throw std::invalid_argument("circle_areas: output span is smaller than input");
+        }
+        switch (selected_isa())
+        {
+#if SHAPE_KERNELS_X86
+        case Isa::AVX2:
+            return detail::column_areas_avx2(detail::RadiusColumn{radii.data()}, out.data(), radii.size());
+        case Isa::SSE2:
+            return detail::column_areas_sse2(detail::RadiusColumn{radii.data()}, out.data(), radii.size());
+#endif
+        default:
+            for (size_t i = 0; i < radii.size(); ++i)
+            {
+                out[i] = detail::PI * radii[i] * radii[i];
+            }
+        }
+    }
+
+    inline void rectangle_areas(std::span<const double> widths, std::span<const double> heights, std::span<double> out)
+    {
+        if (widths.size() != heights.size())
+        {
+            throw std::invalid_argument("rectangle_areas: widths and heights differ in size");
+        }
+        if (out.size() < widths.size())
+        {
+            throw std::invalid_argument("rectangle_areas: output span is smaller than input");
+        }
+        switch (selected_isa())
+        {
+#if SHAPE_KERNELS_X86
+        case Isa::AVX2:
+            return detail::column_areas_avx2(detail::RectangleColumns{widths.data(), heights.data()}, out.data(), widths.size());
+        case Isa::SSE2:
+            return detail::column_areas_sse2(detail::RectangleColumns{widths.data(), heights.data()}, out.data(), widths.size());
+#endif
+        default:
+            for (size_t i = 0; i < widths.size(); ++i)
+            {
+                out[i] = widths[i] * heights[i];
+            }
+        }
+    }
+
+    inline double total_circle_area(std::span<const double> radii)
+    {
+        switch (selected_isa())
+        {
+#if SHAPE_KERNELS_X86
+        case Isa::AVX2:
+            return detail::column_total_avx2(detail::RadiusColumn{radii.data()}, radii.size());
+        case Isa::SSE2:
+            return detail::column_total_sse2(detail::RadiusColumn{radii.data()}, radii.size());
+#endif
+        default:
+            return detail::total_scalar(radii.size(), [&radii](size_t i)
+                                        { return detail::PI * radii[i] * radii[i]; });
+        }
+    }
+
+    inline double total_rectangle_area(std::span<const double> widths, std::span<const double> heights)
+    {
+        if (widths.size() != heights.size())
+        {
+            throw std::invalid_argument("total_rectangle_area: widths and heights differ in size");
+        }
+        switch (selected_isa())
+        {
+#if SHAPE_KERNELS_X86
+        case Isa::AVX2:
+            return detail::column_total_avx2(detail::RectangleColumns{widths.data(), heights.data()}, widths.size());
+        case Isa::SSE2:
+            return detail::column_total_sse2(detail::RectangleColumns{widths.data(), heights.data()}, widths.size());
+#endif
+        default:
+            return detail::total_scalar(widths.size(), [&widths, &heights](size_t i)
+                                        { return widths[i] * heights[i]; });
+        }
+    }
+}
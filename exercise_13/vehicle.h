@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include "../exercise_9/lifecycle_trace.h"
 
 class Vehicle
 {
@@ -12,12 +13,12 @@ private:
 public:
     Vehicle()
     {
-        std::cout << this << ": Vehicle constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Vehicle constructor called: ");
     }
 
     ~Vehicle()
     {
-        std::cout << this << ": Vehicle destructor called: " << std::endl;
+        lifecycle_trace::event(this, "Vehicle destructor called: ");
     }
 
     virtual void print()
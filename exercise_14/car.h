@@ -1,8 +1,9 @@
 #pragma once
 
 #include "vehicle.h"
+#include "../exercise_9/lifecycle_trace.h"
 
-class Car : public Vehicle
+class Car final : public Vehicle
 {
 private:
     int num_doors;
@@ -12,12 +13,33 @@ private:
 public:
     Car()
     {
-        std::cout << this << ": Car constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Car constructor called: ");
+    }
+
+    Car(int id, std::string_view make, std::string_view model, int num_doors, int num_seats, int num_wheels)
+        : Vehicle(id, make, model), num_doors(num_doors), num_seats(num_seats), num_wheels(num_wheels)
+    {
+        lifecycle_trace::event(this, "Car constructor called: ");
     }
 
     ~Car()
     {
-        std::cout << this << ": Car destructor called: " << std::endl;
+        lifecycle_trace::event(this, "Car destructor called: ");
+    }
+
+    int get_num_doors() const
+    {
+        return num_doors;
+    }
+
+    int get_num_seats() const
+    {
+        return num_seats;
+    }
+
+    int get_num_wheels() const override
+    {
+        return num_wheels;
     }
 
     void print() override
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Stable reference to a vehicle parked in a ChunkedGarage. It stays valid while
+// other vehicles are added or removed and is rejected once its own vehicle leaves.
+struct GarageHandle
+{
+    uint32_t slot;
+    uint32_t generation;
+};
+
+// Growable garage that stores vehicles by value. Vehicles are packed densely in
+// fixed-size chunks, so iteration walks contiguous memory and adding never moves
+// an existing vehicle. Chunks are kept for reuse after removals.
+//
+// All memory (chunks and bookkeeping) comes from the std::pmr::memory_resource
+// given to the constructor, e.g. an Arena from exercise_8.
+template <typename T, int CHUNK_SIZE = 1024>
+class ChunkedGarage
+{
+private:
+    enum : uint32_t
+    {
+        INVALID_INDEX = UINT32_MAX
+    };
+
+    struct Chunk
+    {
+        alignas(T) unsigned char storage[sizeof(T) * CHUNK_SIZE];
+    };
+
+    std::pmr::memory_resource *resource;
+    std::pmr::vector<Chunk *> chunks;
+    std::pmr::vector<uint32_t> dense_to_slot;
+    std::pmr::vector<uint32_t> slot_to_dense;
+    std::pmr::vector<uint32_t> generations;
+    std::pmr::vector<uint32_t> free_slots;
+    size_t count = 0;
+
+    T *slot_address(size_t index) const
+    {
+        unsigned char *storage = chunks[index / CHUNK_SIZE]->storage;
+        return reinterpret_cast<T *>(storage + (index % CHUNK_SIZE) * sizeof(T));
+    }
+
+    bool is_valid(GarageHandle handle) const
+    {
+        return handle.slot < generations.size() &&
+               generations[handle.slot] == handle.generation &&
+               slot_to_dense[handle.slot] != INVALID_INDEX;
+    }
+
+    uint32_t allocate_slot()
+    {
+        if (!free_slots.empty())
+        {
+            uint32_t slot = free_slots.back();
+            free_slots.pop_back();
+            return slot;
+        }
+        generations.push_back(0);
+        slot_to_dense.push_back(INVALID_INDEX);
+        return static_cast<uint32_t>(generations.size() - 1);
+    }
+
+public:
+    explicit ChunkedGarage(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : resource(resource), chunks(resource), dense_to_slot(resource), slot_to_dense(resource),
+          generations(resource), free_slots(resource)
+    {
+    }
+
+    ChunkedGarage(const ChunkedGarage &) = delete;
+    ChunkedGarage &operator=(const ChunkedGarage &) = delete;
+
+    ~ChunkedGarage()
+    {
+        clear();
+        shrink_to_fit();
+    }
+
+    template <typename... Args>
+    GarageHandle emplace_vehicle(Args &&...args)
+    {
+        if (count == chunks.size() * CHUNK_SIZE)
+        {
+            chunks.push_back(static_cast<Chunk *>(resource->allocate(sizeof(Chunk), alignof(Chunk))));
+        }
+
+        new (slot_address(count)) T(std::forward<Args>(args)...);
+
+        uint32_t slot = allocate_slot();
+        slot_to_dense[slot] = static_cast<uint32_t>(count);
+        if (dense_to_slot.size() <= count)
+        {
+            dense_to_slot.push_back(slot);
+        }
+        else
+        {
+            dense_to_slot[count] = slot;
+        }
+        ++count;
+
+        return GarageHandle{slot, generations[slot]};
+    }
+
+    GarageHandle add_vehicle(const T &vehicle)
+    {
+        return emplace_vehicle(vehicle);
+    }
+
+    GarageHandle add_vehicle(T &&vehicle)
+    {
+        return emplace_vehicle(std::move(vehicle));
+    }
+
+    // Removes the vehicle in O(1) by moving the last vehicle into its place.
+    bool remove_vehicle(GarageHandle handle)
+    {
+        if (!is_valid(handle))
+        {
+            std::cout << "Vehicle is not in the garage." << std::endl;
+            return false;
+        }
+
+        uint32_t index = slot_to_dense[handle.slot];
+        uint32_t last = static_cast<uint32_t>(count - 1);
+        if (index != last)
+        {
+            *slot_address(index) = std::move(*slot_address(last));
+            uint32_t moved_slot = dense_to_slot[last];
+            dense_to_slot[index] = moved_slot;
+            slot_to_dense[moved_slot] = index;
+        }
+        slot_address(last)->~T();
+        --count;
+
+        slot_to_dense[handle.slot] = INVALID_INDEX;
+        ++generations[handle.slot];
+        free_slots.push_back(handle.slot);
+        return true;
+    }
+
+    T *get_vehicle(GarageHandle handle) const
+    {
+        return is_valid(handle) ? slot_address(slot_to_dense[handle.slot]) : nullptr;
+    }
+
+    // Position-based access; positions change when vehicles are removed.
+    T &operator[](size_t index) const
+    {
+        return *slot_address(index);
+    }
+
+    template <typename Function>
+    void for_each(Function function) const
+    {
+        size_t remaining = count;
+        for (size_t c = 0; remaining > 0; ++c)
+        {
+            T *first = reinterpret_cast<T *>(chunks[c]->storage);
+            size_t in_chunk = remaining < static_cast<size_t>(CHUNK_SIZE) ? remaining : CHUNK_SIZE;
+            for (size_t i = 0; i < in_chunk; ++i)
+            {
+                function(first[i]);
+            }
+            remaining -= in_chunk;
+        }
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            slot_address(i)->~T();
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t slot = dense_to_slot[i];
+            slot_to_dense[slot] = INVALID_INDEX;
+            ++generations[slot];
+            free_slots.push_back(slot);
+        }
+        count = 0;
+    }
+
+    // Releases chunks that no longer hold any vehicle.
+    void shrink_to_fit()
+    {
+        size_t needed = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        while (chunks.size() > needed)
+        {
+            resource->deallocate(chunks.back(), sizeof(Chunk), alignof(Chunk));
+            chunks.pop_back();
+        }
+    }
+
+    void display_vehicles() const
+    {
+        if (count == 0)
+        {
+            std::cout << "Garage is empty." << std::endl;
+        }
+        else
+        {
+            std::cout << "Vehicles in the garage:" << std::endl;
+            for (size_t i = 0; i < count; ++i)
+            {
+                std::cout << slot_address(i) << std::endl;
+            }
+        }
+    }
+
+    size_t get_count() const
+    {
+        return count;
+    }
+
+    size_t get_capacity() const
+    {
+        return chunks.size() * CHUNK_SIZE;
+    }
+};
@@ -0,0 +1,25 @@
+#include <iostream>
+#include "car.h"
+#include "truck.h"
+#include "motorcycle.h"
+#include "../exercise_13/poly_collection.h"
+
+int main()
+{
+    PolyCollection<Car, Truck, Motorcycle> fleet;
+    fleet.reserve(2);
+
+    fleet.emplace<Car>(1, "Toyota", "Corolla", 4, 5, 4);
+    fleet.emplace<Truck>(2, "Volvo", "FH16", 3, 40000, 10);
+    fleet.emplace<Car>(3, "Honda", "Civic", 4, 5, 4);
+    fleet.emplace<Motorcycle>(4, "Ducati", "Monster", 2, 2);
+
+    // One loop per concrete type; Car, Truck and Motorcycle are final, so print()
+    // is called directly instead of through the vtable.
+    fleet.for_each([](auto &vehicle)
+                   { vehicle.print(); });
+
+    std::cout << "Vehicles in the fleet: " << fleet.size() << std::endl;
+
+    return 0;
+}
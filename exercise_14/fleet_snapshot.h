@@ -0,0 +1,408 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "vehicle_registry.h"
+#include "../exercise_18/mapped_file.h"
+
+// A VehicleRegistry on disk, one column per field, laid out so that the file
+// can be mapped and queried where it is: opening a snapshot reads the header,
+// not the rows.
+//
+//   header      "FLEETSNP", version, byte-order mark, row count, column count
+//   directory   per column: id, element size, offset, length, checksum
+//   columns     types, ids, make, model, wheels, seats, doors, axles, cargo,
+//               name offsets, name bytes (each 64-byte aligned)
+//
+// Make and model are indexes into the snapshot's own name table, because
+// interner ids are only valid inside the process that created them. Numbers
+// are stored in host byte order (the byte-order mark rejects a file from a
+// machine with the other one). Every column carries a checksum; opening
+// verifies them unless asked not to, and verify() can do it later.
+//
+//     save_snapshot(registry, "fleet.snap");
+//     FleetSnapshot fleet("fleet.snap");
+//     long long cargo = fleet.total_cargo_capacity();
+
+namespace fleet_snapshot
+{
+    const char MAGIC[8] = {'F', 'L', 'E', 'E', 'T', 'S', 'N', 'P'};
+    const uint32_t VERSION = 1;
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+    const size_t ALIGNMENT = 64;
+
+    enum Column : uint32_t
+    {
+        TYPES,
+        IDS,
+        MAKES,
+        MODELS,
+        WHEELS,
+        SEATS,
+        DOORS,
+        AXLES,
+        CARGO,
+        NAME_OFFSETS, // uint32 per name plus one: name i is bytes [offset[i], offset[i + 1])
+        NAME_BYTES,
+        COLUMN_COUNT
+    };
+
+    const char *const COLUMN_NAMES[COLUMN_COUNT] = {"types", "ids", "makes", "models", "wheels", "seats",
+                                                   "doors", "axles", "cargo", "name offsets", "name bytes"};
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint64_t rows;
+        uint32_t column_count;
+        uint32_t reserved;
+    };
+
+    struct ColumnEntry
+    {
+        uint32_t column;
+        uint32_t element_size;
+        uint64_t offset;
+        uint64_t length; // bytes
+        uint64_t checksum;
+    };
+
+    // Four independent multiply-rotate lanes over 8-byte words, so it runs at
+    // memory speed rather than one multiply latency per word.
+    inline uint64_t checksum(const char *data, size_t size)
+    {
+        const uint64_t PRIME = 0x9E3779B97F4A7C15ull;
+        uint64_t lanes[4] = {1, 2, 3, 4};
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                uint64_t word;
+                std::memcpy(&word, data + i + 8 * lane, 8);
+                lanes[lane] = (lanes[lane] ^ word) * PRIME;
+                lanes[lane] = lanes[lane] << 31 | lanes[lane] >> 33;
+            }
+        }
+        uint64_t hash = size;
+        for (uint64_t lane : lanes)
+        {
+            hash = (hash ^ lane) * PRIME;
+        }
+        for (; i < size; ++i)
+        {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * PRIME;
+        }
+        return hash ^ hash >> 29;
+    }
+
+    inline std::runtime_error corrupt(const std::string &what)
+    {
+        return std::runtime_error("Corrupt fleet snapshot: " + what);
+    }
+}
+
+inline void save_snapshot(const VehicleRegistry &registry, const std::string &filename)
+{
+    using namespace fleet_snapshot;
+
+    // Renumber the interned names used by the fleet as 0, 1, 2, ...
+    const size_t NONE = SIZE_MAX;
+    std::vector<size_t> local_id;
+    std::vector<uint32_t> local_makes(registry.size());
+    std::vector<uint32_t> local_models(registry.size());
+    std::vector<uint32_t> name_offsets(1, 0);
+    std::string name_bytes;
+    auto localize = [&](uint32_t global)
+    {
+        if (global >= local_id.size())
+        {
+            local_id.resize(std::max<size_t>(global + 1, 2 * local_id.size()), NONE);
+        }
+        if (local_id[global] == NONE)
+        {
+            local_id[global] = name_offsets.size() - 1;
+            name_bytes += registry.get_name(global);
+            name_offsets.push_back(static_cast<uint32_t>(name_bytes.size()));
+        }
+        return static_cast<uint32_t>(local_id[global]);
+    };
+    for (size_t row = 0; row < registry.size(); ++row)
+    {
+        local_makes[row] = localize(registry.get_make_ids()[row]);
+        local_models[row] = localize(registry.get_model_ids()[row]);
+    }
+
+    struct Source
+    {
+        const void *data;
+        uint32_t element_size;
+        uint64_t count;
+    };
+    Source sources[COLUMN_COUNT] = {
+        {registry.get_types().data(), sizeof(VehicleType), registry.size()},
+        {registry.get_ids().data(), sizeof(int), registry.size()},
+        {local_makes.data(), sizeof(uint32_t), registry.size()},
+        {local_models.data(), sizeof(uint32_t), registry.size()},
+        {registry.get_num_wheels().data(), sizeof(int), registry.size()},
+        {registry.get_num_seats().data(), sizeof(int), registry.size()},
+        {registry.get_num_doors().data(), sizeof(int), registry.size()},
+        {registry.get_num_axles().data(), sizeof(int), registry.size()},
+        {registry.get_cargo_capacity().data(), sizeof(int), registry.size()},
+        {name_offsets.data(), sizeof(uint32_t), name_offsets.size()},
+        {name_bytes.data(), 1, name_bytes.size()},
+    };
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.rows = registry.size();
+    header.column_count = COLUMN_COUNT;
+
+    ColumnEntry directory[COLUMN_COUNT];
+    uint64_t offset = sizeof(Header) + sizeof(directory);
+    for (uint32_t c = 0; c < COLUMN_COUNT; ++c)
+    {
+        offset = (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        uint64_t length = sources[c].element_size * sources[c].count;
+        directory[c] = ColumnEntry{c, sources[c].element_size, offset, length,
+                                   checksum(static_cast<const char *>(sources[c].data), length)};
+        offset += length;
+    }
+
+    // Written next to the target and renamed over it, so a crash while saving
+    // leaves the previous snapshot in place.
+    std::string temporary = filename + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to open file for writing: " + temporary);
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(directory), sizeof(directory));
+    uint64_t written = sizeof(header) + sizeof(directory);
+    const char padding[ALIGNMENT] = {};
+    for (uint32_t c = 0; c < COLUMN_COUNT; ++c)
+    {
+        file.write(padding, static_cast<std::streamsize>(directory[c].offset - written));
+        file.write(static_cast<const char *>(sources[c].data), static_cast<std::streamsize>(directory[c].length));
+        written = directory[c].offset + directory[c].length;
+    }
+    file.close();
+    if (!file)
+    {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Unable to write to file: " + temporary);
+    }
+
+    // The data must be on disk before the rename makes it the snapshot.
+    int fd = ::open(temporary.c_str(), O_RDONLY);
+    if (fd < 0 || ::fsync(fd) != 0)
+    {
+        std::runtime_error error = system_error_for("Unable to sync file: " + temporary);
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        std::remove(temporary.c_str());
+        throw error;
+    }
+    ::close(fd);
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0)
+    {
+        std::runtime_error error = system_error_for("Unable to replace file: " + filename);
+        std::remove(temporary.c_str());
+        throw error;
+    }
+}
+
+// A mapped snapshot with the read side of VehicleRegistry.
+class FleetSnapshot
+{
+private:
+    MappedFile file;
+    const fleet_snapshot::ColumnEntry *directory = nullptr;
+    size_t rows = 0;
+    size_t name_count = 0;
+
+    template <typename T>
+    const T *column(fleet_snapshot::Column c) const
+    {
+        return reinterpret_cast<const T *>(file.data() + directory[c].offset);
+    }
+
+    std::string_view name(uint32_t local_id) const
+    {
+        if (local_id >= name_count)
+        {
+            throw fleet_snapshot::corrupt("name index out of range");
+        }
+        const uint32_t *offsets = column<uint32_t>(fleet_snapshot::NAME_OFFSETS);
+        return std::string_view(column<char>(fleet_snapshot::NAME_BYTES) + offsets[local_id],
+                                offsets[local_id + 1] - offsets[local_id]);
+    }
+
+public:
+    explicit FleetSnapshot(const std::string &filename, bool verify_checksums = true) : file(filename)
+    {
+        using namespace fleet_snapshot;
+        if (file.size() < sizeof(Header) + COLUMN_COUNT * sizeof(ColumnEntry))
+        {
+            throw corrupt("file too short");
+        }
+        const Header *header = reinterpret_cast<const Header *>(file.data());
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            throw corrupt("not a fleet snapshot");
+        }
+        if (header->byte_order != BYTE_ORDER_MARK)
+        {
+            throw corrupt("written on a machine with a different byte order");
+        }
+        if (header->version != VERSION || header->column_count != COLUMN_COUNT)
+        {
+            throw corrupt("unsupported version");
+        }
+        rows = header->rows;
+        directory = reinterpret_cast<const ColumnEntry *>(file.data() + sizeof(Header));
+
+        const uint32_t element_sizes[COLUMN_COUNT] = {sizeof(VehicleType), sizeof(int), 4, 4, sizeof(int),
+                                                      sizeof(int), sizeof(int), sizeof(int), sizeof(int), 4, 1};
+        for (uint32_t c = 0; c < COLUMN_COUNT; ++c)
+        {
+            const ColumnEntry &entry = directory[c];
+            if (entry.column != c || entry.element_size != element_sizes[c] || entry.offset % ALIGNMENT != 0 ||
+                entry.offset > file.size() || entry.length > file.size() - entry.offset ||
+                entry.length % entry.element_size != 0)
+            {
+                throw corrupt(std::string("bad directory entry for ") + COLUMN_NAMES[c]);
+            }
+            if (c < NAME_OFFSETS && entry.length / entry.element_size != rows)
+            {
+                throw corrupt(std::string("wrong row count in ") + COLUMN_NAMES[c]);
+            }
+        }
+
+        // The name table is small; check it now so name() only has to check the index.
+        name_count = directory[NAME_OFFSETS].length / 4;
+        if (name_count == 0)
+        {
+            throw corrupt("empty name table");
+        }
+        --name_count;
+        const uint32_t *offsets = column<uint32_t>(NAME_OFFSETS);
+        for (size_t i = 0; i < name_count; ++i)
+        {
+            if (offsets[i] > offsets[i + 1])
+            {
+                throw corrupt("name offsets out of order");
+            }
+        }
+        if (offsets[0] != 0 || offsets[name_count] != directory[NAME_BYTES].length)
+        {
+            throw corrupt("name offsets out of range");
+        }
+
+        if (verify_checksums)
+        {
+            verify();
+        }
+    }
+
+    // Recomputes every column's checksum; throws naming the first bad column.
+    void verify() const
+    {
+        using namespace fleet_snapshot;
+        for (uint32_t c = 0; c < COLUMN_COUNT; ++c)
+        {
+            if (checksum(file.data() + directory[c].offset, directory[c].length) != directory[c].checksum)
+            {
+                throw corrupt(std::string("checksum mismatch in ") + COLUMN_NAMES[c]);
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        return rows;
+    }
+
+    long long total_cargo_capacity() const
+    {
+        const int *cargo = column<int>(fleet_snapshot::CARGO);
+        long long total = 0;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            total += cargo[i];
+        }
+        return total;
+    }
+
+    size_t count_by_wheels(int wheels) const
+    {
+        const int *column_data = column<int>(fleet_snapshot::WHEELS);
+        size_t matches = 0;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            matches += column_data[i] == wheels;
+        }
+        return matches;
+    }
+
+    size_t count_by_type(VehicleType type) const
+    {
+        const VehicleType *column_data = column<VehicleType>(fleet_snapshot::TYPES);
+        size_t matches = 0;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            matches += column_data[i] == type;
+        }
+        return matches;
+    }
+
+    // Make and model point into the mapped file.
+    VehicleView view(size_t row) const
+    {
+        using namespace fleet_snapshot;
+        return VehicleView{column<VehicleType>(TYPES)[row], column<int>(IDS)[row],
+                           name(column<uint32_t>(MAKES)[row]), name(column<uint32_t>(MODELS)[row]),
+                           column<int>(WHEELS)[row], column<int>(SEATS)[row], column<int>(DOORS)[row],
+                           column<int>(AXLES)[row], column<int>(CARGO)[row]};
+    }
+
+    // Copies the fleet into a registry (interning the names in this process).
+    VehicleRegistry to_registry() const
+    {
+        VehicleRegistry registry;
+        registry.reserve(rows);
+        for (size_t row = 0; row < rows; ++row)
+        {
+            VehicleView vehicle = view(row);
+            switch (vehicle.type)
+            {
+            case VehicleType::Car:
+                registry.add_car(vehicle.id, vehicle.make, vehicle.model, vehicle.num_doors, vehicle.num_seats, vehicle.num_wheels);
+                break;
+            case VehicleType::Truck:
+                registry.add_truck(vehicle.id, vehicle.make, vehicle.model, vehicle.num_axles, vehicle.cargo_capacity, vehicle.num_wheels);
+                break;
+            case VehicleType::Motorcycle:
+                registry.add_motorcycle(vehicle.id, vehicle.make, vehicle.model, vehicle.num_wheels, vehicle.num_seats);
+                break;
+            default:
+                throw fleet_snapshot::corrupt("unknown vehicle type");
+            }
+        }
+        return registry;
+    }
+};
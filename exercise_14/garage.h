@@ -50,6 +50,11 @@ public:
         }
     }
 
+    T *get_vehicle(int index) const
+    {
+        return (index >= 0 && index < count) ? vehicles[index] : nullptr;
+    }
+
     int get_count() const
     {
         return count;
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include "garage.h"
+#include "chunked_garage.h"
+
+// Plain vehicle record so the benchmark measures storage, not constructor logging.
+struct BenchVehicle
+{
+    int id;
+    int num_wheels;
+    int cargo_capacity;
+    int num_axles;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed_ms(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template <int SIZE>
+void run_pointer_garage()
+{
+    // The pointer array alone is SIZE * 8 bytes, too large for the stack at 10^7.
+    std::unique_ptr<Garage<BenchVehicle, SIZE>> garage(new Garage<BenchVehicle, SIZE>);
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < SIZE; ++i)
+    {
+        garage->add_vehicle(new BenchVehicle{i, 4, i % 100, 2});
+    }
+    double insert_ms = elapsed_ms(start);
+
+    start = Clock::now();
+    long long total = 0;
+    for (int i = 0; i < garage->get_count(); ++i)
+    {
+        total += garage->get_vehicle(i)->cargo_capacity;
+    }
+    double iterate_ms = elapsed_ms(start);
+
+    for (int i = 0; i < garage->get_count(); ++i)
+    {
+        delete garage->get_vehicle(i);
+    }
+
+    std::cout << "Garage<T, " << SIZE << ">\t\tinsert " << insert_ms << " ms\titerate " << iterate_ms
+              << " ms\t(checksum " << total << ")" << std::endl;
+}
+
+template <int SIZE>
+void run_chunked_garage()
+{
+    ChunkedGarage<BenchVehicle> garage;
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < SIZE; ++i)
+    {
+        garage.add_vehicle(BenchVehicle{i, 4, i % 100, 2});
+    }
+    double insert_ms = elapsed_ms(start);
+
+    start = Clock::now();
+    long long total = 0;
+    garage.for_each([&total](const BenchVehicle &vehicle)
+                    { total += vehicle.cargo_capacity; });
+    double iterate_ms = elapsed_ms(start);
+
+    std::cout << "ChunkedGarage<T> x " << SIZE << "\tinsert " << insert_ms << " ms\titerate " << iterate_ms
+              << " ms\t(checksum " << total << ")" << std::endl;
+}
+
+template <int SIZE>
+void run(int max_size)
+{
+    if (SIZE > max_size)
+    {
+        return;
+    }
+    run_pointer_garage<SIZE>();
+    run_chunked_garage<SIZE>();
+}
+
+int main(int argc, char *argv[])
+{
+    int max_size = argc > 1 ? std::atoi(argv[1]) : 10000000;
+
+    run<1000>(max_size);
+    run<10000>(max_size);
+    run<100000>(max_size);
+    run<1000000>(max_size);
+    run<10000000>(max_size);
+
+    return 0;
+}
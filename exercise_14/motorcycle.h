@@ -1,8 +1,9 @@
 #pragma once
 #include <iostream>
 #include "vehicle.h"
+#include "../exercise_9/lifecycle_trace.h"
 
-class Motorcycle : public Vehicle
+class Motorcycle final : public Vehicle
 {
 private:
     int num_wheels;
@@ -11,11 +12,24 @@ private:
 public:
     Motorcycle()
     {
-        std::cout << this << ": Motorcycle constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Motorcycle constructor called: ");
+    }
+    Motorcycle(int id, std::string_view make, std::string_view model, int num_wheels, int num_seats)
+        : Vehicle(id, make, model), num_wheels(num_wheels), num_seats(num_seats)
+    {
+        lifecycle_trace::event(this, "Motorcycle constructor called: ");
     }
     ~Motorcycle()
     {
-        std::cout << this << ": Motorcycle destructor called: " << std::endl;
+        lifecycle_trace::event(this, "Motorcycle destructor called: ");
+    }
+    int get_num_seats() const
+    {
+        return num_seats;
+    }
+    int get_num_wheels() const override
+    {
+        return num_wheels;
     }
     void print() override
     {
@@ -0,0 +1,72 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "vehicle_registry.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed_ms(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static const char *MAKES[] = {"Toyota", "Ford", "Volvo", "Honda", "Scania"};
+static const char *MODELS[] = {"Corolla", "F-150", "FH16", "CBR", "R500"};
+
+int main(int argc, char *argv[])
+{
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    std::vector<std::unique_ptr<Vehicle>> objects;
+    VehicleRegistry registry;
+    objects.reserve(count);
+    registry.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        const char *make = MAKES[i % 5];
+        const char *model = MODELS[i % 5];
+        switch (i % 3)
+        {
+        case 0:
+            objects.emplace_back(new Car(i, make, model, 4, 5, 4));
+            registry.add_car(i, make, model, 4, 5, 4);
+            break;
+        case 1:
+            objects.emplace_back(new Truck(i, make, model, 3, 1000 + i % 500, 10));
+            registry.add_truck(i, make, model, 3, 1000 + i % 500, 10);
+            break;
+        default:
+            objects.emplace_back(new Motorcycle(i, make, model, 2, 2));
+            registry.add_motorcycle(i, make, model, 2, 2);
+            break;
+        }
+    }
+
+    Clock::time_point start = Clock::now();
+    long long object_cargo = 0;
+    size_t object_two_wheels = 0;
+    for (const auto &vehicle : objects)
+    {
+        object_cargo += vehicle->get_cargo_capacity();
+        object_two_wheels += vehicle->get_num_wheels() == 2;
+    }
+    double object_ms = elapsed_ms(start);
+
+    start = Clock::now();
+    long long registry_cargo = registry.total_cargo_capacity();
+    size_t registry_two_wheels = registry.count_by_wheels(2);
+    double registry_ms = elapsed_ms(start);
+
+    std::cout << count << " vehicles" << std::endl;
+    std::cout << "virtual scan:  " << object_ms << " ms (cargo " << object_cargo << ", two-wheelers " << object_two_wheels << ")" << std::endl;
+    std::cout << "columnar scan: " << registry_ms << " ms (cargo " << registry_cargo << ", two-wheelers " << registry_two_wheels << ")" << std::endl;
+
+    if (registry.size() > 1)
+    {
+        registry.view(1).print();
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "fleet_snapshot.h"
+
+// Startup cost of a fleet: building the registry from scratch (what every run
+// does today), saving it as a snapshot, and opening the snapshot with and
+// without checksum verification. Then the same queries on both, and a
+// snapshot with one flipped byte.
+//
+// Usage: snapshot_bench [vehicles]
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed_ms(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static const char *MAKES[] = {"Toyota", "Ford", "Volvo", "Honda", "Scania"};
+static const char *MODELS[] = {"Corolla", "F-150", "FH16", "CBR", "R500"};
+
+int main(int argc, char *argv[])
+{
+    int count = argc > 1 ? std::atoi(argv[1]) : 5000000;
+    const char *filename = "fleet.snap";
+
+    try
+    {
+        Clock::time_point start = Clock::now();
+        VehicleRegistry registry;
+        registry.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            const char *make = MAKES[i % 5];
+            const char *model = MODELS[i % 5];
+            switch (i % 3)
+            {
+            case 0:
+                registry.add_car(i, make, model, 4, 5, 4);
+                break;
+            case 1:
+                registry.add_truck(i, make, model, 3, 1000 + i % 500, 10);
+                break;
+            default:
+                registry.add_motorcycle(i, make, model, 2, 2);
+                break;
+            }
+        }
+        std::cout << count << " vehicles" << std::endl;
+        std::cout << "build registry:     " << elapsed_ms(start) << " ms" << std::endl;
+
+        start = Clock::now();
+        save_snapshot(registry, filename);
+        std::cout << "save snapshot:      " << elapsed_ms(start) << " ms" << std::endl;
+
+        start = Clock::now();
+        {
+            FleetSnapshot unchecked(filename, false);
+            std::cout << "open, no checksums: " << elapsed_ms(start) << " ms (" << unchecked.size() << " rows)" << std::endl;
+        }
+
+        start = Clock::now();
+        FleetSnapshot fleet(filename);
+        std::cout << "open + checksums:   " << elapsed_ms(start) << " ms" << std::endl;
+
+        start = Clock::now();
+        long long cargo = fleet.total_cargo_capacity();
+        size_t two_wheels = fleet.count_by_wheels(2);
+        std::cout << "snapshot scan:      " << elapsed_ms(start) << " ms (cargo " << cargo << ", two-wheelers " << two_wheels << ")" << std::endl;
+
+        start = Clock::now();
+        long long registry_cargo = registry.total_cargo_capacity();
+        size_t registry_two_wheels = registry.count_by_wheels(2);
+        std::cout << "registry scan:      " << elapsed_ms(start) << " ms (cargo " << registry_cargo << ", two-wheelers " << registry_two_wheels << ")" << std::endl;
+
+        start = Clock::now();
+        VehicleRegistry loaded = fleet.to_registry();
+        std::cout << "to_registry:        " << elapsed_ms(start) << " ms" << std::endl;
+
+        if (cargo != registry_cargo || two_wheels != registry_two_wheels || loaded.size() != registry.size() ||
+            loaded.count_by_type(VehicleType::Truck) != registry.count_by_type(VehicleType::Truck))
+        {
+            std::cerr << "Snapshot and registry disagree" << std::endl;
+            return 1;
+        }
+        if (fleet.size() > 1)
+        {
+            fleet.view(1).print();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Damage the first byte of the first non-empty column (found through the
+    // directory, so it is never padding) and open the file again.
+    {
+        std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+        fleet_snapshot::ColumnEntry entry = {};
+        for (uint32_t c = 0; c < fleet_snapshot::COLUMN_COUNT && entry.length == 0; ++c)
+        {
+            file.seekg(sizeof(fleet_snapshot::Header) + c * sizeof(fleet_snapshot::ColumnEntry));
+            file.read(reinterpret_cast<char *>(&entry), sizeof(entry));
+        }
+        char byte = 0;
+        file.seekg(static_cast<std::streamoff>(entry.offset));
+        file.get(byte);
+        file.seekp(static_cast<std::streamoff>(entry.offset));
+        file.put(static_cast<char>(byte ^ 0xff));
+        if (!file)
+        {
+            std::cerr << "Unable to damage " << filename << std::endl;
+            return 1;
+        }
+    }
+    try
+    {
+        FleetSnapshot damaged(filename);
+        std::cerr << "Damaged snapshot was accepted" << std::endl;
+        return 1;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Damaged snapshot: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -1,8 +1,9 @@
 #pragma once
 
 #include "vehicle.h"
+#include "../exercise_9/lifecycle_trace.h"
 
-class Truck : public Vehicle
+class Truck final : public Vehicle
 {
 private:
     int num_axles;
@@ -12,12 +13,33 @@ private:
 public:
     Truck()
     {
-        std::cout << this << ": Truck constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Truck constructor called: ");
+    }
+
+    Truck(int id, std::string_view make, std::string_view model, int num_axles, int cargo_capacity, int num_wheels)
+        : Vehicle(id, make, model), num_axles(num_axles), cargo_capacity(cargo_capacity), num_wheels(num_wheels)
+    {
+        lifecycle_trace::event(this, "Truck constructor called: ");
     }
 
     ~Truck()
     {
-        std::cout << this << ": Truck destructor called: " << std::endl;
+        lifecycle_trace::event(this, "Truck destructor called: ");
+    }
+
+    int get_num_axles() const
+    {
+        return num_axles;
+    }
+
+    int get_cargo_capacity() const override
+    {
+        return cargo_capacity;
+    }
+
+    int get_num_wheels() const override
+    {
+        return num_wheels;
     }
 
     void print() override
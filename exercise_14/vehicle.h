@@ -1,23 +1,57 @@
 #pragma once
 
 #include <iostream>
+#include <string_view>
+#include "../exercise_12/string_interner.h"
+#include "../exercise_9/lifecycle_trace.h"
 
 class Vehicle
 {
 private:
     int id;
-    std::string make;
-    std::string model;
+    Symbol make;
+    Symbol model;
 
 public:
     Vehicle()
     {
-        std::cout << this << ": Vehicle constructor called: " << std::endl;
+        lifecycle_trace::event(this, "Vehicle constructor called: ");
     }
 
-    ~Vehicle()
+    Vehicle(int id, std::string_view make, std::string_view model)
+        : id(id), make(Symbol::intern(make)), model(Symbol::intern(model))
     {
-        std::cout << this << ": Vehicle destructor called: " << std::endl;
+        lifecycle_trace::event(this, "Vehicle constructor called: ");
+    }
+
+    virtual ~Vehicle()
+    {
+        lifecycle_trace::event(this, "Vehicle destructor called: ");
+    }
+
+    int get_id() const
+    {
+        return id;
+    }
+
+    Symbol get_make() const
+    {
+        return make;
+    }
+
+    Symbol get_model() const
+    {
+        return model;
+    }
+
+    virtual int get_num_wheels() const
+    {
+        return 0;
+    }
+
+    virtual int get_cargo_capacity() const
+    {
+        return 0;
     }
 
     virtual void print()
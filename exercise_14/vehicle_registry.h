@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "car.h"
+#include "truck.h"
+#include "motorcycle.h"
+
+enum class VehicleType : uint8_t
+{
+    Car,
+    Truck,
+    Motorcycle
+};
+
+// Read-only view of one registry row, printed the same way as the matching class.
+struct VehicleView
+{
+    VehicleType type;
+    int id;
+    std::string_view make;
+    std::string_view model;
+    int num_wheels;
+    int num_seats;
+    int num_doors;
+    int num_axles;
+    int cargo_capacity;
+
+    void print() const
+    {
+        if (type != VehicleType::Motorcycle)
+        {
+            std::cout << "Vehicle ID: " << id << std::endl
+                      << "Make: " << make << std::endl
+                      << "Model: " << model << std::endl;
+        }
+
+        switch (type)
+        {
+        case VehicleType::Car:
+            std::cout << "Car with " << num_doors << " doors, " << num_seats << " seats, and " << num_wheels << " wheels" << std::endl;
+            break;
+        case VehicleType::Truck:
+            std::cout << "Truck with " << num_axles << " axles, " << cargo_capacity << " lbs of cargo capacity, and " << num_wheels << " wheels" << std::endl;
+            break;
+        case VehicleType::Motorcycle:
+            std::cout << "Motorcycle with " << num_wheels << " wheels and " << num_seats << " seats" << std::endl;
+            break;
+        }
+    }
+};
+
+// Columnar store for the Car/Truck/Motorcycle hierarchy. Every field lives in its
+// own array (make and model as global interner ids), so fleet-wide scans are
+// plain loops over one column instead of a virtual call per heap object.
+// Fields a type does not have are stored as 0.
+class VehicleRegistry
+{
+private:
+    std::vector<VehicleType> types;
+    std::vector<int> ids;
+    std::vector<uint32_t> make_ids;
+    std::vector<uint32_t> model_ids;
+    std::vector<int> num_wheels;
+    std::vector<int> num_seats;
+    std::vector<int> num_doors;
+    std::vector<int> num_axles;
+    std::vector<int> cargo_capacity;
+
+    size_t add_row(VehicleType type, int id, Symbol make, Symbol model,
+                   int wheels, int seats, int doors, int axles, int cargo)
+    {
+        types.push_back(type);
+        ids.push_back(id);
+        make_ids.push_back(make.get_id());
+        model_ids.push_back(model.get_id());
+        num_wheels.push_back(wheels);
+        num_seats.push_back(seats);
+        num_doors.push_back(doors);
+        num_axles.push_back(axles);
+        cargo_capacity.push_back(cargo);
+        return ids.size() - 1;
+    }
+
+public:
+    size_t add_car(int id, std::string_view make, std::string_view model, int doors, int seats, int wheels)
+    {
+        return add_row(VehicleType::Car, id, Symbol::intern(make), Symbol::intern(model), wheels, seats, doors, 0, 0);
+    }
+
+    size_t add_truck(int id, std::string_view make, std::string_view model, int axles, int cargo, int wheels)
+    {
+        return add_row(VehicleType::Truck, id, Symbol::intern(make), Symbol::intern(model), wheels, 0, 0, axles, cargo);
+    }
+
+    size_t add_motorcycle(int id, std::string_view make, std::string_view model, int wheels, int seats)
+    {
+        return add_row(VehicleType::Motorcycle, id, Symbol::intern(make), Symbol::intern(model), wheels, seats, 0, 0, 0);
+    }
+
+    size_t add(const Car &car)
+    {
+        return add_row(VehicleType::Car, car.get_id(), car.get_make(), car.get_model(),
+                       car.get_num_wheels(), car.get_num_seats(), car.get_num_doors(), 0, 0);
+    }
+
+    size_t add(const Truck &truck)
+    {
+        return add_row(VehicleType::Truck, truck.get_id(), truck.get_make(), truck.get_model(),
+                       truck.get_num_wheels(), 0, 0, truck.get_num_axles(), truck.get_cargo_capacity());
+    }
+
+    size_t add(const Motorcycle &motorcycle)
+    {
+        return add_row(VehicleType::Motorcycle, motorcycle.get_id(), motorcycle.get_make(), motorcycle.get_model(),
+                       motorcycle.get_num_wheels(), motorcycle.get_num_seats(), 0, 0, 0);
+    }
+
+    void reserve(size_t count)
+    {
+        types.reserve(count);
+        ids.reserve(count);
+        make_ids.reserve(count);
+        model_ids.reserve(count);
+        num_wheels.reserve(count);
+        num_seats.reserve(count);
+        num_doors.reserve(count);
+        num_axles.reserve(count);
+        cargo_capacity.reserve(count);
+    }
+
+    long long total_cargo_capacity() const
+    {
+        const int *cargo = cargo_capacity.data();
+        size_t count = cargo_capacity.size();
+        long long total = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            total += cargo[i];
+        }
+        return total;
+    }
+
+    size_t count_by_wheels(int wheels) const
+    {
+        const int *column = num_wheels.data();
+        size_t count = num_wheels.size();
+        size_t matches = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            matches += column[i] == wheels;
+        }
+        return matches;
+    }
+
+    size_t count_by_type(VehicleType type) const
+    {
+        const VehicleType *column = types.data();
+        size_t count = types.size();
+        size_t matches = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            matches += column[i] == type;
+        }
+        return matches;
+    }
+
+    VehicleView view(size_t row) const
+    {
+        return VehicleView{types[row], ids[row], get_name(make_ids[row]), get_name(model_ids[row]),
+                           num_wheels[row], num_seats[row], num_doors[row], num_axles[row], cargo_capacity[row]};
+    }
+
+    // Builds a heap object of the row's concrete class for code that needs a real Vehicle.
+    std::unique_ptr<Vehicle> materialize(size_t row) const
+    {
+        std::string_view make = get_name(make_ids[row]);
+        std::string_view model = get_name(model_ids[row]);
+        switch (types[row])
+        {
+        case VehicleType::Car:
+            return std::unique_ptr<Vehicle>(new Car(ids[row], make, model, num_doors[row], num_seats[row], num_wheels[row]));
+        case VehicleType::Truck:
+            return std::unique_ptr<Vehicle>(new Truck(ids[row], make, model, num_axles[row], cargo_capacity[row], num_wheels[row]));
+        case VehicleType::Motorcycle:
+            return std::unique_ptr<Vehicle>(new Motorcycle(ids[row], make, model, num_wheels[row], num_seats[row]));
+        }
+        return nullptr;
+    }
+
+    size_t size() const
+    {
+        return ids.size();
+    }
+
+    const std::vector<int> &get_ids() const
+    {
+        return ids;
+    }
+
+    const std::vector<VehicleType> &get_types() const
+    {
+        return types;
+    }
+
+    const std::vector<uint32_t> &get_make_ids() const
+    {
+        return make_ids;
+    }
+
+    const std::vector<uint32_t> &get_model_ids() const
+    {
+        return model_ids;
+    }
+
+    const std::vector<int> &get_num_wheels() const
+    {
+        return num_wheels;
+    }
+
+    const std::vector<int> &get_num_seats() const
+    {
+        return num_seats;
+    }
+
+    const std::vector<int> &get_num_doors() const
+    {
+        return num_doors;
+    }
+
+    const std::vector<int> &get_num_axles() const
+    {
+        return num_axles;
+    }
+
+    const std::vector<int> &get_cargo_capacity() const
+    {
+        return cargo_capacity;
+    }
+
+    std::string_view get_name(uint32_t name_id) const
+    {
+        return Symbol::from_id(name_id).view();
+    }
+};
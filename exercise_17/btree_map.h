@@ -0,0 +1,537 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// An in-memory B+tree map. A node holds many keys in one array sized to a few
+// cache lines (NODE_BYTES), so a lookup touches about log_B(n) nodes instead
+// of the log_2(n) scattered nodes of std::map. All values live in the leaves,
+// and the leaves are chained, so a range scan is lower_bound() followed by
+// walking arrays.
+//
+//     BTreeMap<std::string, int> ages;
+//     ages["Alice"] = 25;
+//     for (auto it = ages.lower_bound("B"); it != ages.end() && it->first < "D"; ++it) { ... }
+//
+// Keys and values are kept in separate arrays, so iterators return a
+// (first, second) pair of references by value. With the default std::less<>,
+// lookups accept anything comparable with the key. erase() does not merge
+// leaves: a tree that shrinks a lot keeps its nodes until it is cleared.
+// Key and T must be default constructible. Inserts and erases invalidate
+// iterators.
+
+template <typename Key, typename T, typename Compare = std::less<>>
+class BTreeMap
+{
+private:
+    static constexpr size_t NODE_BYTES = 256; // four cache lines of keys (and values) per node
+    static constexpr size_t LEAF_SLOTS = std::max<size_t>(8, NODE_BYTES / (sizeof(Key) + sizeof(T)));
+    static constexpr size_t INNER_SLOTS = std::max<size_t>(8, NODE_BYTES / (sizeof(Key) + sizeof(void *)));
+
+    struct Node
+    {
+        bool is_leaf;
+        uint16_t count = 0;
+
+        explicit Node(bool is_leaf) : is_leaf(is_leaf) {}
+    };
+
+    struct Leaf : Node
+    {
+        Key keys[LEAF_SLOTS];
+        T values[LEAF_SLOTS];
+        Leaf *next = nullptr;
+
+        Leaf() : Node(true) {}
+    };
+
+    // children[i] holds the keys k with keys[i - 1] <= k < keys[i].
+    struct Inner : Node
+    {
+        Key keys[INNER_SLOTS];
+        Node *children[INNER_SLOTS + 1];
+
+        Inner() : Node(false) {}
+    };
+
+    // What a node that split hands to its parent.
+    struct Split
+    {
+        Key separator; // the smallest key in right
+        Node *right = nullptr;
+    };
+
+    Node *root = nullptr;
+    Leaf *first_leaf = nullptr;
+    size_t elements = 0;
+    Compare less;
+
+    template <typename K>
+    size_t child_index(const Inner *inner, const K &key) const
+    {
+        return std::upper_bound(inner->keys, inner->keys + inner->count, key,
+                                [this](const K &k, const Key &separator)
+                                { return less(k, separator); }) -
+               inner->keys;
+    }
+
+    template <typename K>
+    size_t leaf_index(const Leaf *leaf, const K &key) const
+    {
+        return std::lower_bound(leaf->keys, leaf->keys + leaf->count, key,
+                                [this](const Key &k, const K &wanted)
+                                { return less(k, wanted); }) -
+               leaf->keys;
+    }
+
+    template <typename K>
+    Leaf *find_leaf(const K &key) const
+    {
+        Node *node = root;
+        while (!node->is_leaf)
+        {
+            Inner *inner = static_cast<Inner *>(node);
+            node = inner->children[child_index(inner, key)];
+        }
+        return static_cast<Leaf *>(node);
+    }
+
+    static void destroy(Node *node)
+    {
+        if (node->is_leaf)
+        {
+            delete static_cast<Leaf *>(node);
+            return;
+        }
+        Inner *inner = static_cast<Inner *>(node);
+        for (size_t i = 0; i <= inner->count; ++i)
+        {
+            destroy(inner->children[i]);
+        }
+        delete inner;
+    }
+
+    // Inserts key into the subtree; leaf/index report where it went. A full
+    // node splits in half and returns the new right half through split.
+    template <typename K, typename... Args>
+    bool insert_into(Node *node, K &&key, Leaf *&leaf, size_t &index, Split &split, Args &&...args)
+    {
+        if (node->is_leaf)
+        {
+            Leaf *target = static_cast<Leaf *>(node);
+            size_t position = leaf_index(target, key);
+            if (position < target->count && !less(key, target->keys[position]))
+            {
+                leaf = target;
+                index = position;
+                return false;
+            }
+            if (target->count == LEAF_SLOTS)
+            {
+                Leaf *right = new Leaf();
+                size_t half = LEAF_SLOTS / 2;
+                std::move(target->keys + half, target->keys + LEAF_SLOTS, right->keys);
+                std::move(target->values + half, target->values + LEAF_SLOTS, right->values);
+                right->count = static_cast<uint16_t>(LEAF_SLOTS - half);
+                target->count = static_cast<uint16_t>(half);
+                right->next = target->next;
+                target->next = right;
+                if (position > half)
+                {
+                    target = right;
+                    position -= half;
+                }
+                split.right = right;
+            }
+            std::move_backward(target->keys + position, target->keys + target->count, target->keys + target->count + 1);
+            std::move_backward(target->values + position, target->values + target->count, target->values + target->count + 1);
+            target->keys[position] = Key(std::forward<K>(key));
+            target->values[position] = T(std::forward<Args>(args)...);
+            ++target->count;
+            if (split.right != nullptr)
+            {
+                split.separator = static_cast<Leaf *>(split.right)->keys[0];
+            }
+            leaf = target;
+            index = position;
+            return true;
+        }
+
+        Inner *inner = static_cast<Inner *>(node);
+        size_t child = child_index(inner, key);
+        Split child_split;
+        bool inserted = insert_into(inner->children[child], std::forward<K>(key), leaf, index, child_split,
+                                    std::forward<Args>(args)...);
+        if (child_split.right == nullptr)
+        {
+            return inserted;
+        }
+
+        // Put the child's new right half next to it.
+        std::move_backward(inner->keys + child, inner->keys + inner->count, inner->keys + inner->count + 1);
+        std::move_backward(inner->children + child + 1, inner->children + inner->count + 1,
+                           inner->children + inner->count + 2);
+        inner->keys[child] = std::move(child_split.separator);
+        inner->children[child + 1] = child_split.right;
+        ++inner->count;
+
+        if (inner->count == INNER_SLOTS)
+        {
+            // Keys [0, middle) stay, keys[middle] moves up, the rest go right.
+            Inner *right = new Inner();
+            size_t middle = INNER_SLOTS / 2;
+            std::move(inner->keys + middle + 1, inner->keys + INNER_SLOTS, right->keys);
+            std::copy(inner->children + middle + 1, inner->children + INNER_SLOTS + 1, right->children);
+            right->count = static_cast<uint16_t>(INNER_SLOTS - middle - 1);
+            split.separator = std::move(inner->keys[middle]);
+            split.right = right;
+            inner->count = static_cast<uint16_t>(middle);
+        }
+        return inserted;
+    }
+
+    template <typename K, typename... Args>
+    std::pair<Leaf *, size_t> emplace_position(K &&key, bool &inserted, Args &&...args)
+    {
+        if (root == nullptr)
+        {
+            first_leaf = new Leaf();
+            root = first_leaf;
+        }
+        Leaf *leaf = nullptr;
+        size_t index = 0;
+        Split split;
+        inserted = insert_into(root, std::forward<K>(key), leaf, index, split, std::forward<Args>(args)...);
+        if (split.right != nullptr)
+        {
+            Inner *new_root = new Inner();
+            new_root->keys[0] = std::move(split.separator);
+            new_root->children[0] = root;
+            new_root->children[1] = split.right;
+            new_root->count = 1;
+            root = new_root;
+        }
+        elements += inserted;
+        return std::make_pair(leaf, index);
+    }
+
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+
+    template <bool CONST>
+    class Iterator
+    {
+    private:
+        friend class BTreeMap;
+
+        Leaf *leaf = nullptr;
+        size_t index = 0;
+
+        Iterator(Leaf *leaf, size_t index) : leaf(leaf), index(index)
+        {
+            skip_empty();
+        }
+
+        // Past the end of a leaf (or in an emptied one) means the next leaf.
+        void skip_empty()
+        {
+            while (leaf != nullptr && index == leaf->count)
+            {
+                leaf = leaf->next;
+                index = 0;
+            }
+        }
+
+    public:
+        typedef typename std::conditional<CONST, const T, T>::type Value;
+
+        struct Reference
+        {
+            const Key &first;
+            Value &second;
+
+            const Reference *operator->() const
+            {
+                return this;
+            }
+        };
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<Key, T> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Reference reference;
+        typedef Reference pointer;
+
+        Iterator() = default;
+
+        template <bool OTHER, typename = typename std::enable_if<CONST && !OTHER>::type>
+        Iterator(const Iterator<OTHER> &other) : leaf(other.leaf), index(other.index) {}
+
+        Reference operator*() const
+        {
+            return Reference{leaf->keys[index], leaf->values[index]};
+        }
+
+        Reference operator->() const
+        {
+            return **this;
+        }
+
+        Iterator &operator++()
+        {
+            ++index;
+            skip_empty();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return leaf == other.leaf && index == other.index;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+        template <bool>
+        friend class Iterator;
+    };
+
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    BTreeMap() = default;
+
+    BTreeMap(const BTreeMap &) = delete;
+    BTreeMap &operator=(const BTreeMap &) = delete;
+
+    BTreeMap(BTreeMap &&other) noexcept
+        : root(std::exchange(other.root, nullptr)), first_leaf(std::exchange(other.first_leaf, nullptr)),
+          elements(std::exchange(other.elements, 0)) {}
+
+    BTreeMap &operator=(BTreeMap &&other) noexcept
+    {
+        std::swap(root, other.root);
+        std::swap(first_leaf, other.first_leaf);
+        std::swap(elements, other.elements);
+        return *this;
+    }
+
+    ~BTreeMap()
+    {
+        clear();
+    }
+
+    // Bulk build from pairs sorted by key with no duplicates: packs the leaves
+    // full and builds each inner level in one pass, without any splits.
+    static BTreeMap from_sorted(std::vector<std::pair<Key, T>> values)
+    {
+        BTreeMap map;
+        if (values.empty())
+        {
+            return map;
+        }
+        std::vector<Node *> level;
+        std::vector<Key> lowest; // smallest key under each node of the level
+        Leaf *previous = nullptr;
+        for (size_t i = 0; i < values.size(); i += LEAF_SLOTS)
+        {
+            Leaf *leaf = new Leaf();
+            size_t count = std::min(LEAF_SLOTS, values.size() - i);
+            for (size_t j = 0; j < count; ++j)
+            {
+                leaf->keys[j] = std::move(values[i + j].first);
+                leaf->values[j] = std::move(values[i + j].second);
+            }
+            leaf->count = static_cast<uint16_t>(count);
+            (previous == nullptr ? map.first_leaf : previous->next) = leaf;
+            previous = leaf;
+            level.push_back(leaf);
+            lowest.push_back(leaf->keys[0]);
+        }
+        while (level.size() > 1)
+        {
+            std::vector<Node *> parents;
+            std::vector<Key> parent_lowest;
+            for (size_t i = 0; i < level.size(); i += INNER_SLOTS)
+            {
+                Inner *inner = new Inner();
+                size_t count = std::min(INNER_SLOTS, level.size() - i);
+                for (size_t j = 0; j < count; ++j)
+                {
+                    inner->children[j] = level[i + j];
+                    if (j > 0)
+                    {
+                        inner->keys[j - 1] = lowest[i + j];
+                    }
+                }
+                inner->count = static_cast<uint16_t>(count - 1);
+                parents.push_back(inner);
+                parent_lowest.push_back(lowest[i]);
+            }
+            level.swap(parents);
+            lowest.swap(parent_lowest);
+        }
+        map.root = level[0];
+        map.elements = values.size();
+        return map;
+    }
+
+    size_t size() const
+    {
+        return elements;
+    }
+
+    bool empty() const
+    {
+        return elements == 0;
+    }
+
+    void clear()
+    {
+        if (root != nullptr)
+        {
+            destroy(root);
+        }
+        root = nullptr;
+        first_leaf = nullptr;
+        elements = 0;
+    }
+
+    iterator begin()
+    {
+        return iterator(first_leaf, 0);
+    }
+
+    iterator end()
+    {
+        return iterator();
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(first_leaf, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
+    template <typename K>
+    iterator lower_bound(const K &key)
+    {
+        if (root == nullptr)
+        {
+            return end();
+        }
+        Leaf *leaf = find_leaf(key);
+        return iterator(leaf, leaf_index(leaf, key));
+    }
+
+    template <typename K>
+    const_iterator lower_bound(const K &key) const
+    {
+        return const_cast<BTreeMap *>(this)->lower_bound(key);
+    }
+
+    template <typename K>
+    iterator find(const K &key)
+    {
+        iterator it = lower_bound(key);
+        return it != end() && !less(key, it->first) ? it : end();
+    }
+
+    template <typename K>
+    const_iterator find(const K &key) const
+    {
+        return const_cast<BTreeMap *>(this)->find(key);
+    }
+
+    template <typename K>
+    bool contains(const K &key) const
+    {
+        return find(key) != end();
+    }
+
+    template <typename K>
+    size_t count(const K &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <typename K>
+    T &at(const K &key)
+    {
+        iterator it = find(key);
+        if (it == end())
+        {
+            throw std::out_of_range("BTreeMap::at: key not found");
+        }
+        return it->second;
+    }
+
+    template <typename K>
+    const T &at(const K &key) const
+    {
+        return const_cast<BTreeMap *>(this)->at(key);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args)
+    {
+        bool inserted;
+        std::pair<Leaf *, size_t> position = emplace_position(key, inserted, std::forward<Args>(args)...);
+        return std::make_pair(iterator(position.first, position.second), inserted);
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<Key, T> &value)
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    T &operator[](const Key &key)
+    {
+        bool inserted;
+        std::pair<Leaf *, size_t> position = emplace_position(key, inserted);
+        return position.first->values[position.second];
+    }
+
+    template <typename K>
+    size_t erase(const K &key)
+    {
+        if (root == nullptr)
+        {
+            return 0;
+        }
+        Leaf *leaf = find_leaf(key);
+        size_t position = leaf_index(leaf, key);
+        if (position == leaf->count || less(key, leaf->keys[position]))
+        {
+            return 0;
+        }
+        std::move(leaf->keys + position + 1, leaf->keys + leaf->count, leaf->keys + position);
+        std::move(leaf->values + position + 1, leaf->values + leaf->count, leaf->values + position);
+        --leaf->count;
+        leaf->keys[leaf->count] = Key();
+        leaf->values[leaf->count] = T();
+        --elements;
+        return 1;
+    }
+};
@@ -0,0 +1,38 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "flat_hash_map.h"
+
+// map2.cpp with FlatHashMap instead of std::unordered_map.
+int main()
+{
+    FlatHashMap<std::string, int> ages = {{"Charlie", 35}, {"Bob", 30}, {"Alice", 25}};
+
+    // Using iterator to access key-value pairs
+    for (FlatHashMap<std::string, int>::iterator it = ages.begin(); it != ages.end(); ++it)
+    {
+        std::cout << it->first << " is " << it->second << " years old." << std::endl;
+    }
+
+    std::cout << std::endl;
+
+    // Looking up without building a std::string
+    std::string_view name = "Bob";
+    auto found = ages.find(name);
+    if (found != ages.end())
+    {
+        std::cout << found->first << " is " << found->second << " years old." << std::endl;
+    }
+
+    ages.erase("Bob");
+    ages["Dave"] = 40;
+
+    // Using range-based for loop to access key-value pairs
+    for (const auto &pair : ages)
+    {
+        std::cout << pair.first << " is " << pair.second << " years old." << std::endl;
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,711 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// An open-addressing hash map in the style of Abseil's SwissTable: keys and
+// values live in one flat array of slots, and a parallel array of one-byte
+// control words says which slots are full and holds 7 bits of each key's hash.
+// A lookup compares 16 control bytes at once (SSE2, or a plain loop elsewhere)
+// and only looks at the few slots whose 7 bits match.
+//
+// Slots are probed linearly, so erase() can shift the following elements back
+// instead of leaving a tombstone: a table never fills up with deleted entries
+// and never needs a cleanup rehash.
+//
+// The interface is a subset of std::unordered_map. Differences:
+//   - any insert or erase invalidates all iterators and references (elements
+//     move when the table grows and when erase() shifts them back);
+//   - erase(iterator) returns nothing, because an element may have moved into
+//     the erased slot;
+//   - find()/count()/contains()/at() accept anything the hash and equality
+//     accept, e.g. std::string_view or const char * for std::string keys,
+//     without building a std::string.
+//
+//     FlatHashMap<std::string, int> ages = {{"Alice", 25}, {"Bob", 30}};
+//     ages["Charlie"] = 35;
+//     auto it = ages.find(std::string_view("Bob"));
+
+// Default hash: std::hash, with string-like keys hashed as std::string_view
+// so every string type hashes alike.
+template <typename Key>
+struct FlatHash
+{
+    size_t operator()(const Key &key) const
+    {
+        return std::hash<Key>()(key);
+    }
+};
+
+template <>
+struct FlatHash<std::string>
+{
+    typedef void is_transparent;
+
+    size_t operator()(std::string_view key) const
+    {
+        return std::hash<std::string_view>()(key);
+    }
+};
+
+namespace flat_hash_detail
+{
+    typedef int8_t ControlByte;
+    const ControlByte EMPTY = -128; // full slots hold 0..127, the low 7 bits of the hash
+    const size_t GROUP_SIZE = 16;
+
+    // std::hash of an integer is often the integer itself; spread it over all bits.
+    inline uint64_t mix(size_t hash)
+    {
+        uint64_t h = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+        return h ^ h >> 32;
+    }
+
+    // Bit i set for every control byte i of the 16 that satisfies the match.
+    struct Group
+    {
+#if defined(__SSE2__)
+        __m128i bytes;
+
+        explicit Group(const ControlByte *control)
+            : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(control))) {}
+
+        uint32_t match(ControlByte h2) const
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(h2))));
+        }
+
+        uint32_t match_empty() const
+        {
+            return match(EMPTY);
+        }
+
+        uint32_t match_full() const
+        {
+            return static_cast<uint32_t>(~_mm_movemask_epi8(bytes)) & 0xFFFF; // full bytes have the top bit clear
+        }
+#else
+        ControlByte bytes[GROUP_SIZE];
+
+        explicit Group(const ControlByte *control)
+        {
+            std::memcpy(bytes, control, GROUP_SIZE);
+        }
+
+        uint32_t match(ControlByte h2) const
+        {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < GROUP_SIZE; ++i)
+            {
+                mask |= static_cast<uint32_t>(bytes[i] == h2) << i;
+            }
+            return mask;
+        }
+
+        uint32_t match_empty() const
+        {
+            return match(EMPTY);
+        }
+
+        uint32_t match_full() const
+        {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < GROUP_SIZE; ++i)
+            {
+                mask |= static_cast<uint32_t>(bytes[i] >= 0) << i;
+            }
+            return mask;
+        }
+#endif
+    };
+
+    inline int lowest_bit(uint32_t mask)
+    {
+        return __builtin_ctz(mask);
+    }
+}
+
+template <typename Key, typename T, typename Hash = FlatHash<Key>, typename KeyEqual = std::equal_to<>>
+class FlatHashMap
+{
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<const Key, T> value_type;
+    typedef size_t size_type;
+
+private:
+    typedef flat_hash_detail::ControlByte ControlByte;
+    typedef flat_hash_detail::Group Group;
+    static constexpr size_t GROUP_SIZE = flat_hash_detail::GROUP_SIZE;
+    static constexpr size_t MIN_CAPACITY = GROUP_SIZE;
+
+    // Elements are stored as pair<Key, T> so they can be moved when the table
+    // shifts or grows, and handed out as pair<const Key, T> (as Abseil does).
+    typedef std::pair<Key, T> Slot;
+
+    ControlByte *control = nullptr; // capacity + GROUP_SIZE bytes; the last GROUP_SIZE mirror the first
+    Slot *slots = nullptr;
+    size_t mask = 0; // capacity - 1, or 0 before the first insert
+    size_t elements = 0;
+    Hash hasher;
+    KeyEqual equal;
+
+    size_t capacity() const
+    {
+        return slots == nullptr ? 0 : mask + 1;
+    }
+
+    template <typename K>
+    uint64_t hash_of(const K &key) const
+    {
+        return flat_hash_detail::mix(hasher(key));
+    }
+
+    static ControlByte h2(uint64_t hash)
+    {
+        return static_cast<ControlByte>(hash & 0x7F);
+    }
+
+    size_t home(uint64_t hash) const
+    {
+        return static_cast<size_t>(hash >> 7) & mask;
+    }
+
+    void set_control(size_t index, ControlByte value)
+    {
+        control[index] = value;
+        if (index < GROUP_SIZE)
+        {
+            control[mask + 1 + index] = value; // the mirror lets a group load run past the end
+        }
+    }
+
+    value_type &value_at(size_t index) const
+    {
+        return *reinterpret_cast<value_type *>(slots + index);
+    }
+
+    // The slot holding key, or (if absent) SIZE_MAX with the first empty slot
+    // of its probe sequence in empty_slot.
+    template <typename K>
+    size_t find_index(const K &key, uint64_t hash, size_t &empty_slot) const
+    {
+        size_t position = home(hash);
+        while (true)
+        {
+            Group group(control + position);
+            uint32_t empties = group.match_empty();
+            uint32_t candidates = group.match(h2(hash));
+            if (empties != 0)
+            {
+                candidates &= (1u << flat_hash_detail::lowest_bit(empties)) - 1; // nothing probes past an empty slot
+            }
+            while (candidates != 0)
+            {
+                size_t index = (position + flat_hash_detail::lowest_bit(candidates)) & mask;
+                if (equal(slots[index].first, key))
+                {
+                    return index;
+                }
+                candidates &= candidates - 1;
+            }
+            if (empties != 0)
+            {
+                empty_slot = (position + flat_hash_detail::lowest_bit(empties)) & mask;
+                return SIZE_MAX;
+            }
+            position = (position + GROUP_SIZE) & mask;
+        }
+    }
+
+    template <typename K>
+    size_t find_index(const K &key) const
+    {
+        if (elements == 0)
+        {
+            return SIZE_MAX;
+        }
+        size_t empty_slot;
+        return find_index(key, hash_of(key), empty_slot);
+    }
+
+    // Replaces the members only once both arrays exist, so a bad_alloc leaves
+    // the map as it was.
+    void allocate(size_t new_capacity)
+    {
+        ControlByte *new_control = static_cast<ControlByte *>(::operator new(new_capacity + GROUP_SIZE));
+        Slot *new_slots;
+        try
+        {
+            new_slots = static_cast<Slot *>(::operator new(new_capacity * sizeof(Slot), std::align_val_t(alignof(Slot))));
+        }
+        catch (...)
+        {
+            ::operator delete(new_control);
+            throw;
+        }
+        std::memset(new_control, static_cast<unsigned char>(flat_hash_detail::EMPTY), new_capacity + GROUP_SIZE);
+        control = new_control;
+        slots = new_slots;
+        mask = new_capacity - 1;
+    }
+
+    void deallocate()
+    {
+        if (slots != nullptr)
+        {
+            ::operator delete(slots, std::align_val_t(alignof(Slot)));
+            ::operator delete(control);
+        }
+        slots = nullptr;
+        control = nullptr;
+        mask = 0;
+    }
+
+    void destroy_all()
+    {
+        for (size_t i = 0; i < capacity(); ++i)
+        {
+            if (control[i] >= 0)
+            {
+                slots[i].~Slot();
+            }
+        }
+    }
+
+    // Places an element known to be absent; the table has room.
+    size_t place(uint64_t hash, Slot &&slot)
+    {
+        size_t position = home(hash);
+        while (true)
+        {
+            uint32_t empties = Group(control + position).match_empty();
+            if (empties != 0)
+            {
+                size_t index = (position + flat_hash_detail::lowest_bit(empties)) & mask;
+                new (slots + index) Slot(std::move(slot));
+                set_control(index, h2(hash));
+                return index;
+            }
+            position = (position + GROUP_SIZE) & mask;
+        }
+    }
+
+    void resize(size_t new_capacity)
+    {
+        ControlByte *old_control = control;
+        Slot *old_slots = slots;
+        size_t old_capacity = capacity();
+        allocate(new_capacity);
+        for (size_t i = 0; i < old_capacity; ++i)
+        {
+            if (old_control[i] >= 0)
+            {
+                place(hash_of(old_slots[i].first), std::move(old_slots[i]));
+                old_slots[i].~Slot();
+            }
+        }
+        if (old_slots != nullptr)
+        {
+            ::operator delete(old_slots, std::align_val_t(alignof(Slot)));
+            ::operator delete(old_control);
+        }
+    }
+
+    // Keeps at least one slot empty in every probe: the load factor stays <= 7/8.
+    static size_t capacity_for(size_t wanted)
+    {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity - capacity / 8 < wanted)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    // Removes slot index and shifts the following elements back to close the gap.
+    void erase_index(size_t index)
+    {
+        slots[index].~Slot();
+        --elements;
+        size_t hole = index;
+        for (size_t next = (hole + 1) & mask; control[next] != flat_hash_detail::EMPTY; next = (next + 1) & mask)
+        {
+            size_t next_home = home(hash_of(slots[next].first));
+            // Move it back unless its home lies between the hole and where it sits.
+            if (((next - next_home) & mask) >= ((next - hole) & mask))
+            {
+                new (slots + hole) Slot(std::move(slots[next]));
+                slots[next].~Slot();
+                set_control(hole, control[next]);
+                hole = next;
+            }
+        }
+        set_control(hole, flat_hash_detail::EMPTY);
+    }
+
+    template <typename K, typename... Args>
+    std::pair<size_t, bool> try_emplace_index(K &&key, Args &&...args)
+    {
+        uint64_t hash = hash_of(key);
+        size_t empty_slot = 0;
+        if (elements != 0)
+        {
+            size_t index = find_index(key, hash, empty_slot);
+            if (index != SIZE_MAX)
+            {
+                return std::make_pair(index, false);
+            }
+        }
+        // With no elements find_index() was skipped, so place() looks for the
+        // key's own empty slot (the table may still be allocated).
+        bool grow = elements + 1 > capacity() - capacity() / 8;
+        if (grow || elements == 0)
+        {
+            if (grow)
+            {
+                resize(capacity_for(elements + 1));
+            }
+            size_t index = place(hash, Slot(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                                            std::forward_as_tuple(std::forward<Args>(args)...)));
+            ++elements;
+            return std::make_pair(index, true);
+        }
+        new (slots + empty_slot) Slot(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                                      std::forward_as_tuple(std::forward<Args>(args)...));
+        set_control(empty_slot, h2(hash));
+        ++elements;
+        return std::make_pair(empty_slot, true);
+    }
+
+public:
+    template <bool CONST>
+    class Iterator
+    {
+    private:
+        friend class FlatHashMap;
+        typedef typename std::conditional<CONST, const FlatHashMap, FlatHashMap>::type Map;
+
+        Map *map = nullptr;
+        size_t index = 0;
+
+        Iterator(Map *map, size_t index) : map(map), index(index) {}
+
+        void skip_empty()
+        {
+            size_t capacity = map->capacity();
+            while (index < capacity)
+            {
+                uint32_t full = Group(map->control + index).match_full();
+                if (index + GROUP_SIZE > capacity)
+                {
+                    full &= (1u << (capacity - index)) - 1; // not the mirrored bytes
+                }
+                if (full != 0)
+                {
+                    index += flat_hash_detail::lowest_bit(full);
+                    return;
+                }
+                index += GROUP_SIZE;
+            }
+            index = capacity;
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename FlatHashMap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<CONST, const value_type, value_type>::type &reference;
+        typedef typename std::conditional<CONST, const value_type, value_type>::type *pointer;
+
+        Iterator() = default;
+
+        // iterator converts to const_iterator
+        template <bool OTHER, typename = typename std::enable_if<CONST && !OTHER>::type>
+        Iterator(const Iterator<OTHER> &other) : map(other.map), index(other.index) {}
+
+        reference operator*() const
+        {
+            return map->value_at(index);
+        }
+
+        pointer operator->() const
+        {
+            return &map->value_at(index);
+        }
+
+        Iterator &operator++()
+        {
+            ++index;
+            skip_empty();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return index == other.index;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return index != other.index;
+        }
+
+        template <bool>
+        friend class Iterator;
+    };
+
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    FlatHashMap() = default;
+
+    FlatHashMap(std::initializer_list<value_type> values)
+    {
+        reserve(values.size());
+        for (const value_type &value : values)
+        {
+            insert(value);
+        }
+    }
+
+    FlatHashMap(const FlatHashMap &other) : hasher(other.hasher), equal(other.equal)
+    {
+        reserve(other.size());
+        for (const value_type &value : other)
+        {
+            insert(value);
+        }
+    }
+
+    FlatHashMap(FlatHashMap &&other) noexcept
+        : control(std::exchange(other.control, nullptr)), slots(std::exchange(other.slots, nullptr)),
+          mask(std::exchange(other.mask, 0)), elements(std::exchange(other.elements, 0)),
+          hasher(std::move(other.hasher)), equal(std::move(other.equal)) {}
+
+    FlatHashMap &operator=(FlatHashMap other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~FlatHashMap()
+    {
+        destroy_all();
+        deallocate();
+    }
+
+    void swap(FlatHashMap &other) noexcept
+    {
+        std::swap(control, other.control);
+        std::swap(slots, other.slots);
+        std::swap(mask, other.mask);
+        std::swap(elements, other.elements);
+        std::swap(hasher, other.hasher);
+        std::swap(equal, other.equal);
+    }
+
+    size_t size() const
+    {
+        return elements;
+    }
+
+    bool empty() const
+    {
+        return elements == 0;
+    }
+
+    size_t bucket_count() const
+    {
+        return capacity();
+    }
+
+    float load_factor() const
+    {
+        return capacity() == 0 ? 0.0f : static_cast<float>(elements) / capacity();
+    }
+
+    void reserve(size_t wanted)
+    {
+        size_t needed = capacity_for(wanted);
+        if (needed > capacity())
+        {
+            resize(needed);
+        }
+    }
+
+    void clear()
+    {
+        destroy_all();
+        if (control != nullptr)
+        {
+            std::memset(control, static_cast<unsigned char>(flat_hash_detail::EMPTY), capacity() + GROUP_SIZE);
+        }
+        elements = 0;
+    }
+
+    iterator begin()
+    {
+        iterator it(this, 0);
+        it.skip_empty();
+        return it;
+    }
+
+    iterator end()
+    {
+        return iterator(this, capacity());
+    }
+
+    const_iterator begin() const
+    {
+        const_iterator it(this, 0);
+        it.skip_empty();
+        return it;
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, capacity());
+    }
+
+    template <typename K>
+    iterator find(const K &key)
+    {
+        size_t index = find_index(key);
+        return index == SIZE_MAX ? end() : iterator(this, index);
+    }
+
+    template <typename K>
+    const_iterator find(const K &key) const
+    {
+        size_t index = find_index(key);
+        return index == SIZE_MAX ? end() : const_iterator(this, index);
+    }
+
+    template <typename K>
+    bool contains(const K &key) const
+    {
+        return find_index(key) != SIZE_MAX;
+    }
+
+    template <typename K>
+    size_t count(const K &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <typename K>
+    T &at(const K &key)
+    {
+        size_t index = find_index(key);
+        if (index == SIZE_MAX)
+        {
+            throw std::out_of_range("FlatHashMap::at: key not found");
+        }
+        return slots[index].second;
+    }
+
+    template <typename K>
+    const T &at(const K &key) const
+    {
+        return const_cast<FlatHashMap *>(this)->at(key);
+    }
+
+    T &operator[](const Key &key)
+    {
+        size_t index = try_emplace_index(key).first; // may reallocate slots
+        return slots[index].second;
+    }
+
+    T &operator[](Key &&key)
+    {
+        size_t index = try_emplace_index(std::move(key)).first;
+        return slots[index].second;
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args)
+    {
+        std::pair<size_t, bool> result = try_emplace_index(key, std::forward<Args>(args)...);
+        return std::make_pair(iterator(this, result.first), result.second);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(Key &&key, Args &&...args)
+    {
+        std::pair<size_t, bool> result = try_emplace_index(std::move(key), std::forward<Args>(args)...);
+        return std::make_pair(iterator(this, result.first), result.second);
+    }
+
+    template <typename K, typename V>
+    std::pair<iterator, bool> emplace(K &&key, V &&value)
+    {
+        return try_emplace(Key(std::forward<K>(key)), std::forward<V>(value));
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value)
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(std::pair<Key, T> &&value)
+    {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename V>
+    std::pair<iterator, bool> insert_or_assign(const Key &key, V &&value)
+    {
+        std::pair<iterator, bool> result = try_emplace(key, std::forward<V>(value));
+        if (!result.second)
+        {
+            result.first->second = std::forward<V>(value);
+        }
+        return result;
+    }
+
+    template <typename K>
+    size_t erase(const K &key)
+    {
+        size_t index = find_index(key);
+        if (index == SIZE_MAX)
+        {
+            return 0;
+        }
+        erase_index(index);
+        return 1;
+    }
+
+    // Invalidates it and every other iterator.
+    void erase(const_iterator it)
+    {
+        erase_index(it.index);
+    }
+
+    void erase(iterator it)
+    {
+        erase_index(it.index);
+    }
+};
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// An ordered map kept as one sorted std::vector of pairs. Lookups are binary
+// searches over contiguous memory and iteration is a straight walk, so reads
+// are much cheaper than in std::map's red-black tree. An insert or erase moves
+// every later element, so build it in bulk (from_unsorted(), from_sorted(), or
+// insert(first, last)) and then mostly read it.
+//
+//     FlatMap<std::string, int> ages = FlatMap<std::string, int>::from_unsorted(std::move(pairs));
+//     for (auto it = ages.lower_bound("B"); it != ages.end() && it->first < "D"; ++it) { ... }
+//
+// With the default std::less<>, lookups accept anything comparable with the
+// key (std::string_view or const char * for std::string keys). Keys must not
+// be changed through an iterator. Any insert or erase invalidates iterators.
+
+template <typename Key, typename T, typename Compare = std::less<>>
+class FlatMap
+{
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<Key, T> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+private:
+    std::vector<value_type> entries;
+    Compare less;
+
+    struct KeyLess
+    {
+        const Compare &less;
+
+        template <typename K>
+        bool operator()(const value_type &entry, const K &key) const
+        {
+            return less(entry.first, key);
+        }
+
+        template <typename K>
+        bool operator()(const K &key, const value_type &entry) const
+        {
+            return less(key, entry.first);
+        }
+    };
+
+    // Sorts by key and keeps the first of equal keys (as repeated map inserts would).
+    void sort_and_deduplicate(size_t sorted_prefix)
+    {
+        auto by_key = [this](const value_type &a, const value_type &b)
+        {
+            return less(a.first, b.first);
+        };
+        std::stable_sort(entries.begin() + sorted_prefix, entries.end(), by_key);
+        std::inplace_merge(entries.begin(), entries.begin() + sorted_prefix, entries.end(), by_key);
+        auto same_key = [this](const value_type &a, const value_type &b)
+        {
+            return !less(a.first, b.first) && !less(b.first, a.first);
+        };
+        entries.erase(std::unique(entries.begin(), entries.end(), same_key), entries.end());
+    }
+
+public:
+    FlatMap() = default;
+
+    FlatMap(std::initializer_list<value_type> values) : entries(values)
+    {
+        sort_and_deduplicate(0);
+    }
+
+    // Bulk build: O(n log n) once instead of n shifting inserts.
+    static FlatMap from_unsorted(std::vector<value_type> values)
+    {
+        FlatMap map;
+        map.entries = std::move(values);
+        map.sort_and_deduplicate(0);
+        return map;
+    }
+
+    // values must already be sorted by key with no duplicates.
+    static FlatMap from_sorted(std::vector<value_type> values)
+    {
+        FlatMap map;
+        map.entries = std::move(values);
+        return map;
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    bool empty() const
+    {
+        return entries.empty();
+    }
+
+    void reserve(size_t count)
+    {
+        entries.reserve(count);
+    }
+
+    void clear()
+    {
+        entries.clear();
+    }
+
+    iterator begin()
+    {
+        return entries.begin();
+    }
+
+    iterator end()
+    {
+        return entries.end();
+    }
+
+    const_iterator begin() const
+    {
+        return entries.begin();
+    }
+
+    const_iterator end() const
+    {
+        return entries.end();
+    }
+
+    template <typename K>
+    iterator lower_bound(const K &key)
+    {
+        return std::lower_bound(entries.begin(), entries.end(), key, KeyLess{less});
+    }
+
+    template <typename K>
+    const_iterator lower_bound(const K &key) const
+    {
+        return std::lower_bound(entries.begin(), entries.end(), key, KeyLess{less});
+    }
+
+    template <typename K>
+    iterator upper_bound(const K &key)
+    {
+        return std::upper_bound(entries.begin(), entries.end(), key, KeyLess{less});
+    }
+
+    template <typename K>
+    const_iterator upper_bound(const K &key) const
+    {
+        return std::upper_bound(entries.begin(), entries.end(), key, KeyLess{less});
+    }
+
+    template <typename K>
+    iterator find(const K &key)
+    {
+        iterator it = lower_bound(key);
+        return it != entries.end() && !less(key, it->first) ? it : entries.end();
+    }
+
+    template <typename K>
+    const_iterator find(const K &key) const
+    {
+        const_iterator it = lower_bound(key);
+        return it != entries.end() && !less(key, it->first) ? it : entries.end();
+    }
+
+    template <typename K>
+    bool contains(const K &key) const
+    {
+        return find(key) != end();
+    }
+
+    template <typename K>
+    size_t count(const K &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    template <typename K>
+    T &at(const K &key)
+    {
+        iterator it = find(key);
+        if (it == end())
+        {
+            throw std::out_of_range("FlatMap::at: key not found");
+        }
+        return it->second;
+    }
+
+    template <typename K>
+    const T &at(const K &key) const
+    {
+        return const_cast<FlatMap *>(this)->at(key);
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&...args)
+    {
+        iterator it = lower_bound(key);
+        if (it != entries.end() && !less(key, it->first))
+        {
+            return std::make_pair(it, false);
+        }
+        it = entries.emplace(it, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        return std::make_pair(it, true);
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value)
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    // Appends the new pairs and merges them in: one sort of the new ones, not a
+    // shift of the whole vector per pair.
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        size_t old_size = entries.size();
+        entries.insert(entries.end(), first, last);
+        sort_and_deduplicate(old_size);
+    }
+
+    T &operator[](const Key &key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    template <typename K>
+    size_t erase(const K &key)
+    {
+        iterator it = find(key);
+        if (it == end())
+        {
+            return 0;
+        }
+        entries.erase(it);
+        return 1;
+    }
+
+    iterator erase(const_iterator it)
+    {
+        return entries.erase(it);
+    }
+};
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "flat_hash_map.h"
+
+// std::unordered_map<std::string, int> (as in map2.cpp) against FlatHashMap:
+// insert, lookups that hit, lookups that miss, iteration and erase, at sizes
+// from 1K up to the given maximum. Small sizes repeat each step so every
+// measurement covers at least 1M operations. Times are nanoseconds per operation.
+//
+// Usage: hash_map_bench [max entries]
+
+typedef std::chrono::steady_clock Clock;
+
+static double ns_per(Clock::time_point start, size_t operations)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+}
+
+template <typename Map>
+void run(const char *name, const std::vector<std::string> &keys, const std::vector<std::string> &misses,
+         const std::vector<size_t> &order)
+{
+    size_t n = keys.size();
+    size_t rounds = std::max<size_t>(1, 1000000 / n);
+    double insert_ns = 0, hit_ns = 0, miss_ns = 0, iterate_ns = 0, erase_ns = 0;
+    long long checksum = 0;
+
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        Map map;
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < n; ++i)
+        {
+            map[keys[i]] = static_cast<int>(i);
+        }
+        insert_ns += ns_per(start, n * rounds);
+
+        start = Clock::now();
+        for (size_t i : order)
+        {
+            checksum += map.find(keys[i])->second;
+        }
+        hit_ns += ns_per(start, n * rounds);
+
+        start = Clock::now();
+        for (size_t i : order)
+        {
+            checksum += map.find(misses[i]) == map.end();
+        }
+        miss_ns += ns_per(start, n * rounds);
+
+        start = Clock::now();
+        for (const auto &pair : map)
+        {
+            checksum += pair.second;
+        }
+        iterate_ns += ns_per(start, n * rounds);
+
+        start = Clock::now();
+        for (size_t i : order)
+        {
+            checksum += map.erase(keys[i]);
+        }
+        erase_ns += ns_per(start, n * rounds);
+        if (!map.empty())
+        {
+            std::fprintf(stderr, "%s: not empty after erasing every key\n", name);
+            std::exit(1);
+        }
+    }
+
+    std::printf("%-14s %10zu %8.1f %8.1f %8.1f %8.1f %8.1f   (%lld)\n", name, n, insert_ns, hit_ns, miss_ns,
+                iterate_ns, erase_ns, checksum);
+}
+
+// Inserts into a map whose slots are allocated but hold no elements: after
+// reserve(), from an initializer list and after erasing everything. Every key
+// must then be found and assigning to it must not add a second copy.
+static void check_empty_table_inserts()
+{
+    FlatHashMap<std::string, int> reserved;
+    reserved.reserve(100);
+    FlatHashMap<std::string, int> listed = {{"Charlie", 35}, {"Bob", 30}, {"Alice", 25}};
+    FlatHashMap<std::string, int> emptied = {{"Charlie", 35}};
+    emptied.erase("Charlie");
+
+    struct Case
+    {
+        const char *name;
+        FlatHashMap<std::string, int> &map;
+    } cases[] = {{"reserve", reserved}, {"initializer list", listed}, {"erase all", emptied}};
+    for (Case &c : cases)
+    {
+        for (const char *key : {"Charlie", "Bob", "Alice", "Dave"})
+        {
+            c.map.try_emplace(key, 0);
+        }
+        for (const char *key : {"Charlie", "Bob", "Alice", "Dave"})
+        {
+            c.map[key] = 99;
+            if (!c.map.contains(key) || c.map.size() != 4)
+            {
+                std::fprintf(stderr, "FlatHashMap (%s): lost or duplicated %s\n", c.name, key);
+                std::exit(1);
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    check_empty_table_inserts();
+
+    size_t max_entries = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::printf("%-14s %10s %8s %8s %8s %8s %8s   ns/op\n", "map", "entries", "insert", "hit", "miss", "iterate", "erase");
+    for (size_t n = 1000; n <= max_entries; n *= 10)
+    {
+        std::vector<std::string> keys(n);
+        std::vector<std::string> misses(n);
+        std::vector<size_t> order(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            keys[i] = "name" + std::to_string(i);
+            misses[i] = "miss" + std::to_string(i);
+            order[i] = i;
+        }
+        std::shuffle(order.begin(), order.end(), std::mt19937_64(n));
+
+        run<std::unordered_map<std::string, int>>("unordered_map", keys, misses, order);
+        run<FlatHashMap<std::string, int>>("FlatHashMap", keys, misses, order);
+    }
+
+    return 0;
+}
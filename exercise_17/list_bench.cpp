@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <list>
+#include "unrolled_list.h"
+
+// std::list<int> (as in list1.cpp) and std::deque<int> against UnrolledList<int>:
+// push_back, push_front, a full traversal, and inserting one element before
+// every 8th element during a walk, at sizes from 1K up to the given maximum.
+// std::deque inserts in the middle in O(n), so its walk-and-insert step is only
+// run up to 100K elements. Small sizes repeat each step so every measurement
+// covers at least 1M elements. Times are nanoseconds per element.
+//
+// Usage: list_bench [max elements]
+
+typedef std::chrono::steady_clock Clock;
+
+static const size_t INSERT_EVERY = 8;
+static const size_t DEQUE_INSERT_LIMIT = 100000;
+
+static double ns_per(Clock::time_point start, size_t operations)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+}
+
+template <typename List>
+void run(const char *name, size_t n, bool insert_in_middle)
+{
+    size_t rounds = std::max<size_t>(1, 1000000 / n);
+    double back_ns = 0, front_ns = 0, traverse_ns = 0, insert_ns = 0;
+    long long checksum = 0;
+
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        List list;
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < n / 2; ++i)
+        {
+            list.push_back(static_cast<int>(i));
+        }
+        back_ns += ns_per(start, n / 2 * rounds);
+
+        start = Clock::now();
+        for (size_t i = n / 2; i < n; ++i)
+        {
+            list.push_front(static_cast<int>(i));
+        }
+        front_ns += ns_per(start, (n - n / 2) * rounds);
+
+        start = Clock::now();
+        for (int value : list)
+        {
+            checksum += value;
+        }
+        traverse_ns += ns_per(start, n * rounds);
+
+        if (insert_in_middle)
+        {
+            start = Clock::now();
+            size_t position = 0;
+            for (auto it = list.begin(); it != list.end(); ++it, ++position)
+            {
+                if (position % INSERT_EVERY == 0)
+                {
+                    it = list.insert(it, -1);
+                    ++it;
+                }
+            }
+            insert_ns += ns_per(start, n / INSERT_EVERY * rounds);
+            checksum += list.size();
+        }
+    }
+
+    if (insert_in_middle)
+    {
+        std::printf("%-14s %10zu %8.1f %8.1f %8.1f %8.1f   (%lld)\n", name, n, back_ns, front_ns, traverse_ns,
+                    insert_ns, checksum);
+    }
+    else
+    {
+        std::printf("%-14s %10zu %8.1f %8.1f %8.1f %8s   (%lld)\n", name, n, back_ns, front_ns, traverse_ns, "-",
+                    checksum);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t max_elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    std::printf("%-14s %10s %8s %8s %8s %8s   ns/element\n", "list", "elements", "back", "front", "traverse",
+                "insert");
+    for (size_t n = 1000; n <= max_elements; n *= 10)
+    {
+        run<std::list<int>>("list", n, true);
+        run<std::deque<int>>("deque", n, n <= DEQUE_INSERT_LIMIT);
+        run<UnrolledList<int>>("UnrolledList", n, true);
+    }
+
+    return 0;
+}
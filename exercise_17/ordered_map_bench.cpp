@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "btree_map.h"
+#include "flat_map.h"
+
+// std::map<std::string, int> (as in map1.cpp) against FlatMap and BTreeMap:
+// building from keys in random order, lookups that hit, range scans (a
+// lower_bound() and the next 100 entries) and a full in-order walk, at sizes
+// from 1K up to the given maximum. FlatMap and BTreeMap are built in bulk
+// (sort once, then from_sorted()); BTreeMap's one-by-one insert is shown as
+// well. Small sizes repeat each step so every measurement covers at least 1M
+// operations. Times are nanoseconds per operation (per entry for scans).
+//
+// Usage: ordered_map_bench [max entries]
+
+typedef std::chrono::steady_clock Clock;
+
+static const size_t SCAN_LENGTH = 100;
+
+static double ns_per(Clock::time_point start, size_t operations)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations;
+}
+
+template <typename Map>
+Map build(const std::vector<std::pair<std::string, int>> &shuffled);
+
+template <>
+std::map<std::string, int> build(const std::vector<std::pair<std::string, int>> &shuffled)
+{
+    return std::map<std::string, int>(shuffled.begin(), shuffled.end());
+}
+
+template <>
+FlatMap<std::string, int> build(const std::vector<std::pair<std::string, int>> &shuffled)
+{
+    return FlatMap<std::string, int>::from_unsorted(shuffled);
+}
+
+template <>
+BTreeMap<std::string, int> build(const std::vector<std::pair<std::string, int>> &shuffled)
+{
+    std::vector<std::pair<std::string, int>> sorted = shuffled;
+    std::sort(sorted.begin(), sorted.end());
+    return BTreeMap<std::string, int>::from_sorted(std::move(sorted));
+}
+
+// BTreeMap filled with one insert per key instead of the bulk build.
+struct InsertedBTreeMap : BTreeMap<std::string, int>
+{
+};
+
+template <>
+InsertedBTreeMap build(const std::vector<std::pair<std::string, int>> &shuffled)
+{
+    InsertedBTreeMap map;
+    for (const auto &pair : shuffled)
+    {
+        map.insert(pair);
+    }
+    return map;
+}
+
+template <typename Map>
+void run(const char *name, const std::vector<std::pair<std::string, int>> &shuffled,
+         const std::vector<std::string> &keys)
+{
+    size_t n = shuffled.size();
+    size_t rounds = std::max<size_t>(1, 1000000 / n);
+    size_t scans = std::max<size_t>(1, n / SCAN_LENGTH);
+    double build_ns = 0, hit_ns = 0, scan_ns = 0, iterate_ns = 0;
+    long long checksum = 0;
+
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        Clock::time_point start = Clock::now();
+        Map map = build<Map>(shuffled);
+        build_ns += ns_per(start, n * rounds);
+        if (map.size() != n)
+        {
+            std::fprintf(stderr, "%s: built %zu entries instead of %zu\n", name, map.size(), n);
+            std::exit(1);
+        }
+
+        start = Clock::now();
+        for (const auto &pair : shuffled)
+        {
+            checksum += map.find(pair.first)->second;
+        }
+        hit_ns += ns_per(start, n * rounds);
+
+        start = Clock::now();
+        for (size_t s = 0; s < scans; ++s)
+        {
+            auto it = map.lower_bound(keys[(s * 7919) % n]);
+            for (size_t i = 0; i < SCAN_LENGTH && it != map.end(); ++i, ++it)
+            {
+                checksum += it->second;
+            }
+        }
+        scan_ns += ns_per(start, scans * SCAN_LENGTH * rounds);
+
+        start = Clock::now();
+        for (const auto &pair : map)
+        {
+            checksum += pair.second;
+        }
+        iterate_ns += ns_per(start, n * rounds);
+    }
+
+    std::printf("%-14s %10zu %8.1f %8.1f %8.1f %8.1f   (%lld)\n", name, n, build_ns, hit_ns, scan_ns, iterate_ns,
+                checksum);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t max_entries = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    std::printf("%-14s %10s %8s %8s %8s %8s   ns/op\n", "map", "entries", "build", "hit", "scan", "iterate");
+    for (size_t n = 1000; n <= max_entries; n *= 10)
+    {
+        std::vector<std::pair<std::string, int>> shuffled(n);
+        std::vector<std::string> keys(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            keys[i] = "name" + std::to_string(i);
+            shuffled[i] = std::make_pair(keys[i], static_cast<int>(i));
+        }
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64(n));
+
+        run<std::map<std::string, int>>("map", shuffled, keys);
+        run<FlatMap<std::string, int>>("FlatMap", shuffled, keys);
+        run<BTreeMap<std::string, int>>("BTreeMap", shuffled, keys);
+        run<InsertedBTreeMap>("BTreeMap/ins", shuffled, keys);
+    }
+
+    return 0;
+}
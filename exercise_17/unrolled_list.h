@@ -0,0 +1,418 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// A linked list of blocks, each holding many elements in an array (an
+// "unrolled" list). std::list<int> allocates a node with two pointers for every
+// 4-byte int; here one allocation of BLOCK_BYTES (a multiple of the cache
+// line) holds over a hundred ints, and a traversal walks arrays.
+//
+//     UnrolledList<int> numbers = {3, 1, 4, 1, 5, 9};
+//     numbers.push_front(0);
+//     numbers.push_back(2);
+//
+// push_front(), push_back(), pop_front(), pop_back() and splice() are O(1) and
+// never move existing elements, so they keep iterators and references to other
+// elements valid, as with std::list. insert() and erase() in the middle move up
+// to one block of elements and invalidate iterators into that block. Iterators
+// are forward only.
+
+template <typename T, size_t BLOCK_BYTES = 512>
+class UnrolledList
+{
+private:
+    static constexpr size_t CACHE_LINE = 64;
+    static_assert(BLOCK_BYTES % CACHE_LINE == 0, "BLOCK_BYTES must be a multiple of the cache line");
+
+    static constexpr size_t HEADER_BYTES = 2 * sizeof(void *) + 2 * sizeof(uint32_t);
+    static constexpr size_t CAPACITY =
+        std::max<size_t>(4, BLOCK_BYTES > HEADER_BYTES + sizeof(T) ? (BLOCK_BYTES - HEADER_BYTES) / sizeof(T) : 0);
+
+    // The live elements are slots [first, last). A block is never empty.
+    struct alignas(CACHE_LINE) Block
+    {
+        Block *prev = nullptr;
+        Block *next = nullptr;
+        uint32_t first = 0;
+        uint32_t last = 0;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[CAPACITY];
+
+        T *slots()
+        {
+            return reinterpret_cast<T *>(storage);
+        }
+    };
+
+    Block *head = nullptr;
+    Block *tail = nullptr;
+    size_t elements = 0;
+
+    // Links block (already filled) between prev and next; either may be null.
+    void link(Block *block, Block *prev, Block *next)
+    {
+        block->prev = prev;
+        block->next = next;
+        (prev != nullptr ? prev->next : head) = block;
+        (next != nullptr ? next->prev : tail) = block;
+    }
+
+    void unlink(Block *block)
+    {
+        (block->prev != nullptr ? block->prev->next : head) = block->next;
+        (block->next != nullptr ? block->next->prev : tail) = block->prev;
+    }
+
+    static void destroy(Block *block)
+    {
+        T *slots = block->slots();
+        for (uint32_t i = block->first; i < block->last; ++i)
+        {
+            slots[i].~T();
+        }
+        delete block;
+    }
+
+    // Moves slots [from, to) of block into a new block, starting at slot 0.
+    static Block *move_to_new_block(Block *block, uint32_t from, uint32_t to)
+    {
+        Block *moved = new Block;
+        T *source = block->slots();
+        T *target = moved->slots();
+        for (uint32_t i = from; i < to; ++i)
+        {
+            new (&target[moved->last++]) T(std::move(source[i]));
+            source[i].~T();
+        }
+        return moved;
+    }
+
+public:
+    typedef T value_type;
+
+    template <bool CONST>
+    class Iterator
+    {
+    private:
+        friend class UnrolledList;
+
+        Block *block = nullptr;
+        uint32_t index = 0;
+
+        Iterator(Block *block, uint32_t index) : block(block), index(index) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<CONST, const T, T>::type &reference;
+        typedef typename std::conditional<CONST, const T, T>::type *pointer;
+
+        Iterator() = default;
+
+        template <bool OTHER, typename = typename std::enable_if<CONST && !OTHER>::type>
+        Iterator(const Iterator<OTHER> &other) : block(other.block), index(other.index) {}
+
+        reference operator*() const
+        {
+            return block->slots()[index];
+        }
+
+        pointer operator->() const
+        {
+            return &block->slots()[index];
+        }
+
+        Iterator &operator++()
+        {
+            if (++index == block->last)
+            {
+                block = block->next;
+                index = block != nullptr ? block->first : 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const Iterator &other) const
+        {
+            return block == other.block && index == other.index;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+        template <bool>
+        friend class Iterator;
+    };
+
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    UnrolledList() = default;
+
+    UnrolledList(std::initializer_list<T> values)
+    {
+        for (const T &value : values)
+        {
+            push_back(value);
+        }
+    }
+
+    UnrolledList(const UnrolledList &other)
+    {
+        for (const T &value : other)
+        {
+            push_back(value);
+        }
+    }
+
+    UnrolledList(UnrolledList &&other) noexcept
+        : head(std::exchange(other.head, nullptr)), tail(std::exchange(other.tail, nullptr)),
+          elements(std::exchange(other.elements, 0)) {}
+
+    UnrolledList &operator=(UnrolledList other) noexcept
+    {
+        std::swap(head, other.head);
+        std::swap(tail, other.tail);
+        std::swap(elements, other.elements);
+        return *this;
+    }
+
+    ~UnrolledList()
+    {
+        clear();
+    }
+
+    size_t size() const
+    {
+        return elements;
+    }
+
+    bool empty() const
+    {
+        return elements == 0;
+    }
+
+    void clear()
+    {
+        while (head != nullptr)
+        {
+            Block *next = head->next;
+            destroy(head);
+            head = next;
+        }
+        tail = nullptr;
+        elements = 0;
+    }
+
+    iterator begin()
+    {
+        return iterator(head, head != nullptr ? head->first : 0);
+    }
+
+    iterator end()
+    {
+        return iterator();
+    }
+
+    const_iterator begin() const
+    {
+        return const_cast<UnrolledList *>(this)->begin();
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
+    T &front()
+    {
+        return head->slots()[head->first];
+    }
+
+    T &back()
+    {
+        return tail->slots()[tail->last - 1];
+    }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        if (tail == nullptr || tail->last == CAPACITY)
+        {
+            link(new Block, tail, nullptr);
+        }
+        T *slot = new (&tail->slots()[tail->last]) T(std::forward<Args>(args)...);
+        ++tail->last;
+        ++elements;
+        return *slot;
+    }
+
+    // A new front block is filled from its end, so pushes keep going down.
+    template <typename... Args>
+    T &emplace_front(Args &&...args)
+    {
+        if (head == nullptr || head->first == 0)
+        {
+            Block *block = new Block;
+            block->first = block->last = CAPACITY;
+            link(block, nullptr, head);
+        }
+        T *slot = new (&head->slots()[head->first - 1]) T(std::forward<Args>(args)...);
+        --head->first;
+        ++elements;
+        return *slot;
+    }
+
+    void push_back(const T &value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T &&value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    void push_front(const T &value)
+    {
+        emplace_front(value);
+    }
+
+    void push_front(T &&value)
+    {
+        emplace_front(std::move(value));
+    }
+
+    void pop_back()
+    {
+        erase(iterator(tail, tail->last - 1));
+    }
+
+    void pop_front()
+    {
+        erase(begin());
+    }
+
+    // Inserts before pos. A full block is split in two first.
+    iterator insert(const_iterator pos, T value)
+    {
+        if (pos.block == nullptr)
+        {
+            emplace_back(std::move(value));
+            return iterator(tail, tail->last - 1);
+        }
+        Block *block = pos.block;
+        uint32_t index = pos.index;
+        if (block->first == 0 && block->last == CAPACITY)
+        {
+            uint32_t middle = CAPACITY / 2;
+            link(move_to_new_block(block, middle, CAPACITY), block, block->next);
+            block->last = middle;
+            if (index >= middle)
+            {
+                block = block->next;
+                index -= middle;
+            }
+        }
+
+        T *slots = block->slots();
+        if (block->last < CAPACITY)
+        {
+            // Shift [index, last) up by one.
+            new (&slots[block->last]) T(std::move(value));
+            std::rotate(slots + index, slots + block->last, slots + block->last + 1);
+            ++block->last;
+        }
+        else
+        {
+            // Shift [first, index) down by one.
+            --index;
+            new (&slots[block->first - 1]) T(std::move(value));
+            std::rotate(slots + block->first - 1, slots + block->first, slots + index + 1);
+            --block->first;
+        }
+        ++elements;
+        return iterator(block, index);
+    }
+
+    // Returns the element after pos. An emptied block is freed. Erasing the
+    // first element of a block moves nothing, so pop_front() is O(1).
+    iterator erase(const_iterator pos)
+    {
+        Block *block = pos.block;
+        T *slots = block->slots();
+        uint32_t next_index = pos.index;
+        if (pos.index == block->first)
+        {
+            slots[block->first++].~T();
+            next_index = block->first;
+        }
+        else
+        {
+            std::move(slots + pos.index + 1, slots + block->last, slots + pos.index);
+            slots[--block->last].~T();
+        }
+        --elements;
+        if (block->first == block->last)
+        {
+            Block *next = block->next;
+            unlink(block);
+            delete block;
+            return iterator(next, next != nullptr ? next->first : 0);
+        }
+        if (next_index == block->last)
+        {
+            return iterator(block->next, block->next != nullptr ? block->next->first : 0);
+        }
+        return iterator(block, next_index);
+    }
+
+    // Moves every element of other in front of pos without copying them:
+    // other's blocks are linked in, so iterators into other stay valid (and now
+    // point into this list). When pos is inside a block, the elements of that
+    // block before pos move to a new block, which invalidates iterators to them.
+    void splice(const_iterator pos, UnrolledList &other)
+    {
+        if (other.head == nullptr || &other == this)
+        {
+            return;
+        }
+        Block *prev = tail;
+        Block *next = nullptr;
+        if (pos.block != nullptr)
+        {
+            next = pos.block;
+            prev = next->prev;
+            if (pos.index != next->first)
+            {
+                Block *before = move_to_new_block(next, next->first, pos.index);
+                next->first = pos.index;
+                link(before, prev, next);
+                prev = before;
+            }
+        }
+        other.head->prev = prev;
+        other.tail->next = next;
+        (prev != nullptr ? prev->next : head) = other.head;
+        (next != nullptr ? next->prev : tail) = other.tail;
+        elements += other.elements;
+        other.head = other.tail = nullptr;
+        other.elements = 0;
+    }
+};
@@ -0,0 +1,35 @@
+#include <iostream>
+#include "unrolled_list.h"
+
+int main()
+{
+    UnrolledList<int> myList = {3, 1, 4, 1, 5, 9};
+
+    myList.push_front(0);
+    myList.push_back(2);
+
+    for (const auto &elem : myList)
+    {
+        std::cout << elem << " ";
+    }
+    // Output: 0 3 1 4 1 5 9 2
+
+    std::cout << std::endl;
+
+    // Move every element of another list in front of the 4, without copying them
+    UnrolledList<int> other = {7, 7};
+    UnrolledList<int>::iterator four = myList.begin();
+    for (int i = 0; i < 3; ++i)
+    {
+        ++four;
+    }
+    myList.splice(four, other);
+
+    for (const auto &elem : myList)
+    {
+        std::cout << elem << " ";
+    }
+    // Output: 0 3 1 7 7 4 1 5 9 2
+
+    return 0;
+}
@@ -1,30 +1,8 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include "person.h"
 
-class Person
-{
-public:
-    std::string name;
-    int age;
-
-    Person() : name(""), age(0) {}
-    Person(const std::string &n, int a) : name(n), age(a) {}
-
-    // Overload << operator for writing to file
-    friend std::ostream &operator<<(std::ostream &os, const Person &p)
-    {
-        os << p.name << " " << p.age;
-        return os;
-    }
-
-    // Overload >> operator for reading from file
-    friend std::istream &operator>>(std::istream &is, Person &p)
-    {
-        is >> p.name >> p.age;
-        return is;
-    }
-};
 void writePeopleToFile(const std::string &filename)
 {
     try
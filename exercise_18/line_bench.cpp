@@ -0,0 +1,112 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "mapped_file.h"
+
+// Reads every line of a file four ways and echoes it to /dev/null:
+//   fstream1     - the loop in fstream1.cpp: std::getline, then << std::endl
+//   getline      - the same, but '\n' instead of std::endl (no flush per line)
+//   read()       - LineReader's buffered fallback (what a pipe gets)
+//   mmap         - LineReader on the mapped file
+//
+// Usage: line_bench [file] [lines]
+// Without a file, one with the given number of lines (default 2M) is generated.
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Loop>
+void run(const char *name, const std::string &filename, Loop loop)
+{
+    std::ofstream sink("/dev/null");
+    Clock::time_point start = Clock::now();
+    size_t lines = 0;
+    size_t bytes = 0;
+    loop(filename, sink, lines, bytes);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::printf("%-9s %9zu lines %8.3f s %9.1f MB/s\n", name, lines, seconds, bytes / seconds / 1e6);
+}
+
+void write_sink(std::ofstream &sink, std::string_view line)
+{
+    sink.write(line.data(), static_cast<std::streamsize>(line.size()));
+    sink.put('\n');
+}
+
+int main(int argc, char *argv[])
+{
+    std::string filename = argc > 1 ? argv[1] : "lines.txt";
+    if (argc <= 1)
+    {
+        long count = argc > 2 ? std::atol(argv[2]) : 2000000;
+        std::ofstream out(filename);
+        for (long i = 0; i < count; ++i)
+        {
+            out << "2024-01-01T00:00:00 INFO request " << i << " served in " << i % 997 << " us\n";
+        }
+    }
+
+    try
+    {
+        run("fstream1", filename, [](const std::string &name, std::ofstream &sink, size_t &lines, size_t &bytes)
+            {
+                std::ifstream input_file(name);
+                std::string line;
+                while (std::getline(input_file, line))
+                {
+                    sink << line << std::endl;
+                    ++lines;
+                    bytes += line.size() + 1;
+                } });
+
+        run("getline", filename, [](const std::string &name, std::ofstream &sink, size_t &lines, size_t &bytes)
+            {
+                std::ifstream input_file(name);
+                std::string line;
+                while (std::getline(input_file, line))
+                {
+                    sink << line << '\n';
+                    ++lines;
+                    bytes += line.size() + 1;
+                } });
+
+        run("read()", filename, [](const std::string &name, std::ofstream &sink, size_t &lines, size_t &bytes)
+            {
+                int fd = ::open(name.c_str(), O_RDONLY);
+                if (fd < 0)
+                {
+                    throw system_error_for("Failed to open file: " + name);
+                }
+                LineReader reader(fd);
+                std::string_view line;
+                while (reader.next(line))
+                {
+                    write_sink(sink, line);
+                    ++lines;
+                    bytes += line.size() + 1;
+                }
+                ::close(fd); });
+
+        run("mmap", filename, [](const std::string &name, std::ofstream &sink, size_t &lines, size_t &bytes)
+            {
+                LineReader reader(name);
+                std::string_view line;
+                while (reader.next(line))
+                {
+                    write_sink(sink, line);
+                    ++lines;
+                    bytes += line.size() + 1;
+                } });
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Zero-copy reading of large text files.
+//
+// MappedFile maps a whole file read-only into memory. LineReader hands out one
+// std::string_view per line, pointing straight into the mapping; the view is
+// valid until the reader is destroyed. Newlines are found with memchr(), which
+// the C library implements with SIMD. Pipes, terminals and anything else that
+// can't be mapped are read with large read() calls instead; there a line is
+// only valid until the next call to next().
+//
+//     LineReader reader("huge.log");
+//     std::string_view line;
+//     while (reader.next(line)) { ... }
+//
+// As with std::getline, the '\n' is not part of the line and a last line
+// without a '\n' is still returned.
+
+inline std::runtime_error system_error_for(const std::string &what)
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+class MappedFile
+{
+private:
+    const char *start = nullptr;
+    size_t length = 0;
+
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw system_error_for("Failed to open file: " + path);
+        }
+        try
+        {
+            map(fd, path);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd); // the mapping keeps the file alive
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept
+        : start(std::exchange(other.start, nullptr)), length(std::exchange(other.length, 0)) {}
+
+    MappedFile &operator=(MappedFile &&other) noexcept
+    {
+        std::swap(start, other.start);
+        std::swap(length, other.length);
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+        if (start != nullptr)
+        {
+            ::munmap(const_cast<char *>(start), length);
+        }
+    }
+
+    // Maps an open descriptor; throws if it isn't a regular file.
+    void map(int fd, const std::string &path)
+    {
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            throw system_error_for("Failed to stat file: " + path);
+        }
+        if (!S_ISREG(info.st_mode))
+        {
+            throw std::runtime_error("Not a regular file: " + path);
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        if (size == 0)
+        {
+            return; // mmap() rejects empty mappings; an empty view is fine
+        }
+        void *memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (memory == MAP_FAILED)
+        {
+            throw system_error_for("Failed to map file: " + path);
+        }
+        ::madvise(memory, size, MADV_SEQUENTIAL);
+        start = static_cast<const char *>(memory);
+        length = size;
+    }
+
+    const char *data() const
+    {
+        return start;
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+
+    std::string_view view() const
+    {
+        return std::string_view(start, length);
+    }
+};
+
+class LineReader
+{
+private:
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    MappedFile mapping;
+    std::string_view rest; // unread part of the mapping
+
+    int fd = -1;            // read() fallback
+    bool owns_fd = false;
+    bool end_of_input = false;
+    std::vector<char> buffer;
+    size_t begin = 0; // unread bytes are buffer[begin, end)
+    size_t end = 0;
+
+    bool next_mapped(std::string_view &line)
+    {
+        if (rest.empty())
+        {
+            return false;
+        }
+        const char *newline = static_cast<const char *>(std::memchr(rest.data(), '\n', rest.size()));
+        size_t length = newline == nullptr ? rest.size() : static_cast<size_t>(newline - rest.data());
+        line = rest.substr(0, length);
+        rest.remove_prefix(newline == nullptr ? length : length + 1);
+        return true;
+    }
+
+    // Moves the unread bytes to the front (growing the buffer for a line longer
+    // than it) and fills the space after them.
+    void refill()
+    {
+        if (begin > 0)
+        {
+            std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+        }
+        if (end == buffer.size())
+        {
+            buffer.resize(buffer.size() * 2);
+        }
+        while (true)
+        {
+            ssize_t count = ::read(fd, buffer.data() + end, buffer.size() - end);
+            if (count > 0)
+            {
+                end += static_cast<size_t>(count);
+                return;
+            }
+            if (count == 0)
+            {
+                end_of_input = true;
+                return;
+            }
+            if (errno != EINTR)
+            {
+                throw system_error_for("Failed to read file");
+            }
+        }
+    }
+
+    bool next_buffered(std::string_view &line)
+    {
+        size_t searched = begin;
+        while (true)
+        {
+            const char *newline = static_cast<const char *>(
+                std::memchr(buffer.data() + searched, '\n', end - searched));
+            if (newline != nullptr)
+            {
+                size_t position = static_cast<size_t>(newline - buffer.data());
+                line = std::string_view(buffer.data() + begin, position - begin);
+                begin = position + 1;
+                return true;
+            }
+            if (end_of_input)
+            {
+                if (begin == end)
+                {
+                    return false;
+                }
+                line = std::string_view(buffer.data() + begin, end - begin);
+                begin = end;
+                return true;
+            }
+            size_t unread = end - begin;
+            refill();
+            searched = unread; // refill() moved the unread bytes to the front
+        }
+    }
+
+public:
+    // Maps the file if it can; "-" reads standard input.
+    explicit LineReader(const std::string &path)
+    {
+        if (path == "-")
+        {
+            fd = STDIN_FILENO;
+        }
+        else
+        {
+            fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw system_error_for("Failed to open file: " + path);
+            }
+            owns_fd = true;
+            struct stat info;
+            if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+            {
+                try
+                {
+                    mapping.map(fd, path);
+                }
+                catch (...)
+                {
+                    ::close(fd); // the destructor does not run if the constructor throws
+                    throw;
+                }
+                rest = mapping.view();
+                ::close(fd);
+                fd = -1;
+                owns_fd = false;
+                return;
+            }
+        }
+        buffer.resize(BUFFER_SIZE);
+    }
+
+    // Always reads with read(); the caller keeps ownership of fd.
+    explicit LineReader(int fd) : fd(fd), buffer(BUFFER_SIZE) {}
+
+    LineReader(const LineReader &) = delete;
+    LineReader &operator=(const LineReader &) = delete;
+
+    ~LineReader()
+    {
+        if (owns_fd)
+        {
+            ::close(fd);
+        }
+    }
+
+    bool is_mapped() const
+    {
+        return fd < 0;
+    }
+
+    bool next(std::string_view &line)
+    {
+        return is_mapped() ? next_mapped(line) : next_buffered(line);
+    }
+};
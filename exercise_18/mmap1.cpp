@@ -0,0 +1,34 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "mapped_file.h"
+
+// fstream1.cpp without a std::string per line or a flush per line.
+// "-" reads standard input, e.g. `cat example.txt | ./mmap1 -`.
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <filename>" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        LineReader reader(argv[1]);
+        std::string_view line;
+        while (reader.next(line))
+        {
+            // Process each line
+            std::fwrite(line.data(), 1, line.size(), stdout);
+            std::fputc('\n', stdout);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "person_parser.h"
+
+// Loads a text file of people (the format of fstream2.cpp) with the >> loop of
+// readPeopleFromFile, with parse_people() on one thread, and with load_people()
+// on 1, 2, 4, ... threads up to the number of cores.
+//
+// Usage: parse_bench [records]
+
+typedef std::chrono::steady_clock Clock;
+
+void report(const char *name, unsigned threads, size_t records, Clock::time_point start)
+{
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::printf("%-14s %2u threads %8.3f s %8.2f M records/s\n", name, threads, seconds, records / seconds / 1e6);
+}
+
+bool same(const std::vector<Person> &a, const std::vector<Person> &b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (a[i].name != b[i].name || a[i].age != b[i].age)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    long records = argc > 1 ? std::atol(argv[1]) : 10000000;
+    std::string filename = "people.txt";
+    {
+        std::ofstream file(filename);
+        for (long i = 0; i < records; ++i)
+        {
+            file << Person("Person" + std::to_string(i), static_cast<int>(i % 100)) << '\n';
+        }
+    }
+
+    try
+    {
+        Clock::time_point start = Clock::now();
+        std::vector<Person> expected;
+        {
+            std::ifstream file(filename);
+            Person readPerson;
+            while (file >> readPerson)
+            {
+                expected.push_back(readPerson);
+            }
+        }
+        report("istream >>", 1, expected.size(), start);
+
+        start = Clock::now();
+        std::vector<Person> people;
+        {
+            MappedFile file(filename);
+            people = parse_people(file.view());
+        }
+        report("parse_people", 1, people.size(), start);
+        if (!same(people, expected))
+        {
+            std::cerr << "parse_people disagrees with operator>>" << std::endl;
+            return 1;
+        }
+
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned threads = 1;; threads *= 2)
+        {
+            threads = std::min(threads, cores);
+            start = Clock::now();
+            people = load_people(filename, threads);
+            report("load_people", threads, people.size(), start);
+            if (!same(people, expected))
+            {
+                std::cerr << "load_people disagrees with operator>>" << std::endl;
+                return 1;
+            }
+            if (threads == cores)
+            {
+                break;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
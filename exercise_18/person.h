@@ -0,0 +1,28 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+class Person
+{
+public:
+    std::string name;
+    int age;
+
+    Person() : name(""), age(0) {}
+    Person(const std::string &n, int a) : name(n), age(a) {}
+
+    // Overload << operator for writing to file
+    friend std::ostream &operator<<(std::ostream &os, const Person &p)
+    {
+        os << p.name << " " << p.age;
+        return os;
+    }
+
+    // Overload >> operator for reading from file
+    friend std::istream &operator>>(std::istream &is, Person &p)
+    {
+        is >> p.name >> p.age;
+        return is;
+    }
+};
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "person_binary.h"
+
+// Writes and reads the same people as text (Person's << and >>, as in
+// fstream2.cpp) and in the binary format of person_binary.h, then looks up
+// random records in the binary file.
+//
+// Usage: person_bench [records]
+
+typedef std::chrono::steady_clock Clock;
+
+double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report(const char *name, long records, double seconds)
+{
+    std::printf("%-16s %8.3f s %8.2f M records/s\n", name, seconds, records / seconds / 1e6);
+}
+
+int main(int argc, char *argv[])
+{
+    long records = argc > 1 ? std::atol(argv[1]) : 10000000;
+
+    std::vector<Person> people;
+    people.reserve(records);
+    for (long i = 0; i < records; ++i)
+    {
+        people.emplace_back("Person" + std::to_string(i), static_cast<int>(i % 100));
+    }
+
+    try
+    {
+        Clock::time_point start = Clock::now();
+        {
+            std::ofstream file("people.txt");
+            for (const Person &p : people)
+            {
+                file << p << '\n';
+            }
+        }
+        report("text write", records, seconds_since(start));
+
+        start = Clock::now();
+        long text_ages = 0;
+        {
+            std::ifstream file("people.txt");
+            Person readPerson;
+            while (file >> readPerson)
+            {
+                text_ages += readPerson.age;
+            }
+        }
+        report("text read", records, seconds_since(start));
+
+        start = Clock::now();
+        {
+            PersonWriter writer("people.bin");
+            for (const Person &p : people)
+            {
+                writer.write(p);
+            }
+            writer.close();
+        }
+        report("binary write", records, seconds_since(start));
+
+        start = Clock::now();
+        long binary_ages = 0;
+        PersonReader reader("people.bin");
+        PersonView person;
+        while (reader.next(person))
+        {
+            binary_ages += person.age;
+        }
+        report("binary read", records, seconds_since(start));
+
+        if (text_ages != binary_ages || reader.size() != static_cast<uint64_t>(records))
+        {
+            std::cerr << "Text and binary files disagree" << std::endl;
+            return 1;
+        }
+
+        long lookups = std::min(records, 1000000L);
+        std::mt19937_64 random(42);
+        start = Clock::now();
+        for (long i = 0; i < lookups; ++i)
+        {
+            uint64_t n = random() % reader.size();
+            PersonView found = reader.at(n);
+            if (found.name != people[n].name || found.age != people[n].age)
+            {
+                std::cerr << "Record " << n << " does not match" << std::endl;
+                return 1;
+            }
+        }
+        report("binary at(n)", lookups, seconds_since(start));
+
+        // Text can't hold a name with a space; binary round-trips it.
+        {
+            PersonWriter writer("spaces.bin", false);
+            writer.write(Person("Mary Ann", 41));
+            writer.write(Person("", 7));
+        }
+        PersonReader spaces("spaces.bin");
+        std::cout << "Read: " << spaces.at(0).name << ", " << spaces.at(0).age << " (without index)" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
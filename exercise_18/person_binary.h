@@ -0,0 +1,333 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mapped_file.h"
+#include "person.h"
+
+// A binary file of Person records: no parsing, names may contain any bytes
+// (spaces included), and with the index record N is found without reading
+// records 0..N-1. All integers are little-endian.
+//
+//   header   32 bytes  "PRSN", version (u16), flags (u16), reserved (u32),
+//                      record count (u64), index offset (u64, 0 = no index)
+//   records            age (i32), name length (u32), name bytes
+//   index              one u64 file offset per record (if FLAG_INDEX)
+//
+// PersonWriter streams records out and writes the header last. PersonReader
+// maps the file and returns PersonView (a name that points into the mapping)
+// either sequentially with next() or by position with at().
+
+namespace person_binary
+{
+    const char MAGIC[4] = {'P', 'R', 'S', 'N'};
+    const uint16_t VERSION = 1;
+    const uint16_t FLAG_INDEX = 1;
+    const size_t HEADER_SIZE = 32;
+    const size_t RECORD_HEADER_SIZE = 8;
+
+    inline void store_u16(char *out, uint16_t value)
+    {
+        out[0] = static_cast<char>(value);
+        out[1] = static_cast<char>(value >> 8);
+    }
+
+    inline void store_u32(char *out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            out[i] = static_cast<char>(value >> (8 * i));
+        }
+    }
+
+    inline void store_u64(char *out, uint64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            out[i] = static_cast<char>(value >> (8 * i));
+        }
+    }
+
+    inline uint16_t load_u16(const char *in)
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(in);
+        return static_cast<uint16_t>(bytes[0] | bytes[1] << 8);
+    }
+
+    inline uint32_t load_u32(const char *in)
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(in);
+        uint32_t value = 0;
+        for (int i = 3; i >= 0; --i)
+        {
+            value = value << 8 | bytes[i];
+        }
+        return value;
+    }
+
+    inline uint64_t load_u64(const char *in)
+    {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(in);
+        uint64_t value = 0;
+        for (int i = 7; i >= 0; --i)
+        {
+            value = value << 8 | bytes[i];
+        }
+        return value;
+    }
+}
+
+struct PersonView
+{
+    std::string_view name;
+    int age;
+
+    Person to_person() const
+    {
+        return Person(std::string(name), age);
+    }
+};
+
+class PersonWriter
+{
+private:
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    std::ofstream file;
+    std::string buffer;
+    uint64_t offset = person_binary::HEADER_SIZE; // of the next record
+    uint64_t count = 0;
+    bool with_index;
+    std::vector<uint64_t> offsets;
+    bool closed = false;
+
+    void flush_buffer()
+    {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+        if (!file)
+        {
+            throw std::runtime_error("Unable to write to file");
+        }
+    }
+
+public:
+    explicit PersonWriter(const std::string &filename, bool with_index = true)
+        : file(filename, std::ios::binary | std::ios::trunc), with_index(with_index)
+    {
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Unable to open file for writing: " + filename);
+        }
+        buffer.reserve(BUFFER_SIZE);
+        buffer.append(person_binary::HEADER_SIZE, '\0'); // filled in by close()
+    }
+
+    PersonWriter(const PersonWriter &) = delete;
+    PersonWriter &operator=(const PersonWriter &) = delete;
+
+    ~PersonWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (const std::exception &)
+        {
+            // Call close() yourself to see write errors.
+        }
+    }
+
+    void write(std::string_view name, int age)
+    {
+        if (name.size() > UINT32_MAX)
+        {
+            throw std::length_error("Name too long");
+        }
+        if (with_index)
+        {
+            offsets.push_back(offset);
+        }
+        char record[person_binary::RECORD_HEADER_SIZE];
+        person_binary::store_u32(record, static_cast<uint32_t>(age));
+        person_binary::store_u32(record + 4, static_cast<uint32_t>(name.size()));
+        buffer.append(record, sizeof(record));
+        buffer.append(name.data(), name.size());
+        offset += sizeof(record) + name.size();
+        ++count;
+        if (buffer.size() >= BUFFER_SIZE)
+        {
+            flush_buffer();
+        }
+    }
+
+    void write(const Person &p)
+    {
+        write(p.name, p.age);
+    }
+
+    // Writes the index and the header. Nothing can be written afterwards.
+    void close()
+    {
+        if (closed)
+        {
+            return;
+        }
+        closed = true;
+        uint64_t index_offset = 0;
+        if (with_index)
+        {
+            index_offset = offset;
+            char entry[8];
+            for (uint64_t record_offset : offsets)
+            {
+                person_binary::store_u64(entry, record_offset);
+                buffer.append(entry, sizeof(entry));
+                if (buffer.size() >= BUFFER_SIZE)
+                {
+                    flush_buffer();
+                }
+            }
+        }
+        flush_buffer();
+
+        char header[person_binary::HEADER_SIZE] = {};
+        std::memcpy(header, person_binary::MAGIC, sizeof(person_binary::MAGIC));
+        person_binary::store_u16(header + 4, person_binary::VERSION);
+        person_binary::store_u16(header + 6, with_index ? person_binary::FLAG_INDEX : 0);
+        person_binary::store_u64(header + 16, count);
+        person_binary::store_u64(header + 24, index_offset);
+        file.seekp(0);
+        file.write(header, sizeof(header));
+        file.close();
+        if (!file)
+        {
+            throw std::runtime_error("Unable to write to file");
+        }
+    }
+
+    uint64_t size() const
+    {
+        return count;
+    }
+};
+
+class PersonReader
+{
+private:
+    MappedFile mapping;
+    uint64_t count = 0;
+    const char *index = nullptr;        // the index in the file, if there is one
+    std::vector<uint64_t> built_offsets; // otherwise built on first use of at()
+    uint64_t position = person_binary::HEADER_SIZE;
+    uint64_t records_read = 0;
+
+    [[noreturn]] static void corrupt(const char *what)
+    {
+        throw std::runtime_error(std::string("Corrupt person file: ") + what);
+    }
+
+    // Decodes the record at offset and returns the offset of the next one.
+    uint64_t decode(uint64_t offset, PersonView &person) const
+    {
+        uint64_t end = index != nullptr ? static_cast<uint64_t>(index - mapping.data()) : mapping.size();
+        if (offset > end || end - offset < person_binary::RECORD_HEADER_SIZE)
+        {
+            corrupt("record out of bounds");
+        }
+        const char *record = mapping.data() + offset;
+        uint32_t length = person_binary::load_u32(record + 4);
+        if (end - offset - person_binary::RECORD_HEADER_SIZE < length)
+        {
+            corrupt("name out of bounds");
+        }
+        person.age = static_cast<int>(person_binary::load_u32(record));
+        person.name = std::string_view(record + person_binary::RECORD_HEADER_SIZE, length);
+        return offset + person_binary::RECORD_HEADER_SIZE + length;
+    }
+
+    uint64_t offset_of(uint64_t i)
+    {
+        if (index != nullptr)
+        {
+            return person_binary::load_u64(index + 8 * i);
+        }
+        if (built_offsets.empty())
+        {
+            built_offsets.reserve(count);
+            uint64_t offset = person_binary::HEADER_SIZE;
+            PersonView person;
+            for (uint64_t r = 0; r < count; ++r)
+            {
+                built_offsets.push_back(offset);
+                offset = decode(offset, person);
+            }
+        }
+        return built_offsets[i];
+    }
+
+public:
+    explicit PersonReader(const std::string &filename) : mapping(filename)
+    {
+        const char *data = mapping.data();
+        if (mapping.size() < person_binary::HEADER_SIZE ||
+            std::memcmp(data, person_binary::MAGIC, sizeof(person_binary::MAGIC)) != 0)
+        {
+            corrupt("not a person file");
+        }
+        if (person_binary::load_u16(data + 4) != person_binary::VERSION)
+        {
+            corrupt("unsupported version");
+        }
+        count = person_binary::load_u64(data + 16);
+        if ((person_binary::load_u16(data + 6) & person_binary::FLAG_INDEX) != 0)
+        {
+            uint64_t index_offset = person_binary::load_u64(data + 24);
+            if (index_offset < person_binary::HEADER_SIZE || index_offset > mapping.size() ||
+                (mapping.size() - index_offset) / 8 < count)
+            {
+                corrupt("index out of bounds");
+            }
+            index = data + index_offset;
+        }
+    }
+
+    uint64_t size() const
+    {
+        return count;
+    }
+
+    bool has_index() const
+    {
+        return index != nullptr;
+    }
+
+    // The next record in file order; false after the last one.
+    bool next(PersonView &person)
+    {
+        if (records_read == count)
+        {
+            return false;
+        }
+        position = decode(position, person);
+        ++records_read;
+        return true;
+    }
+
+    // Record i. Without an index the first call scans the file once.
+    PersonView at(uint64_t i)
+    {
+        if (i >= count)
+        {
+            throw std::out_of_range("Person index out of range");
+        }
+        PersonView person;
+        decode(offset_of(i), person);
+        return person;
+    }
+};
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "mapped_file.h"
+#include "person.h"
+
+// Loads the text format of fstream2.cpp ("name age" per line) without
+// std::istream. parse_people() is a hand-written parser: no locale, no sentry
+// objects, no virtual calls per character. load_people() maps the file, cuts it
+// into chunks that end on a newline, parses the chunks on several threads and
+// returns the people in file order.
+//
+// Like operator>>, any whitespace separates records, but the name and the age
+// must be on the same line, separated by spaces or tabs (chunks are split at
+// newlines, so the result never depends on where a chunk ends). Malformed
+// input throws std::runtime_error instead of silently stopping.
+
+namespace person_parser
+{
+    inline bool is_space(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    inline const char *skip_space(const char *p, const char *end)
+    {
+        while (p != end && is_space(*p))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    // Skips spaces and tabs only, so it never leaves the line.
+    inline const char *skip_blank(const char *p, const char *end)
+    {
+        while (p != end && (*p == ' ' || *p == '\t'))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    inline const char *token_end(const char *p, const char *end)
+    {
+        while (p != end && !is_space(*p))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    // Calls work(0) ... work(count - 1) on up to threads threads (including
+    // this one); each thread takes the next unclaimed index.
+    template <typename Work>
+    void for_each_chunk(size_t count, unsigned threads, Work work)
+    {
+        std::atomic<size_t> next{0};
+        auto run = [&]()
+        {
+            for (size_t c = next++; c < count; c = next++)
+            {
+                work(c);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < std::min<size_t>(threads, count); ++t)
+        {
+            workers.emplace_back(run);
+        }
+        run();
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    [[noreturn]] inline void malformed(const std::string &what, std::string_view token)
+    {
+        throw std::runtime_error("Malformed person record: " + what + " '" + std::string(token) + "'");
+    }
+
+    inline int parse_age(std::string_view token)
+    {
+        size_t i = 0;
+        bool negative = false;
+        if (i < token.size() && (token[i] == '-' || token[i] == '+'))
+        {
+            negative = token[i] == '-';
+            ++i;
+        }
+        if (i == token.size())
+        {
+            malformed("bad age", token);
+        }
+        long long value = 0;
+        for (; i < token.size(); ++i)
+        {
+            unsigned digit = static_cast<unsigned char>(token[i]) - '0';
+            if (digit > 9)
+            {
+                malformed("bad age", token);
+            }
+            value = value * 10 + digit;
+            if (value > 2147483648LL)
+            {
+                malformed("age out of range", token);
+            }
+        }
+        if (negative)
+        {
+            value = -value;
+        }
+        if (value > 2147483647LL)
+        {
+            malformed("age out of range", token);
+        }
+        return static_cast<int>(value);
+    }
+}
+
+// Appends every person in text to people.
+inline void parse_people(std::string_view text, std::vector<Person> &people)
+{
+    using namespace person_parser;
+    const char *p = text.data();
+    const char *end = p + text.size();
+    while (true)
+    {
+        p = skip_space(p, end);
+        if (p == end)
+        {
+            return;
+        }
+        const char *name_end = token_end(p, end);
+        std::string_view name(p, static_cast<size_t>(name_end - p));
+        p = skip_blank(name_end, end);
+        if (p == end || is_space(*p))
+        {
+            malformed("missing age after", name);
+        }
+        const char *age_end = token_end(p, end);
+        int age = parse_age(std::string_view(p, static_cast<size_t>(age_end - p)));
+        people.emplace_back(std::string(name), age);
+        p = age_end;
+    }
+}
+
+inline std::vector<Person> parse_people(std::string_view text)
+{
+    std::vector<Person> people;
+    parse_people(text, people);
+    return people;
+}
+
+// threads == 0 uses one thread per core.
+inline std::vector<Person> load_people(const std::string &filename, unsigned threads = 0)
+{
+    MappedFile file(filename);
+    std::string_view text = file.view();
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // More chunks than threads, so a thread that finishes early takes another.
+    const size_t MIN_CHUNK = 1 << 20;
+    size_t chunk_count = std::max<size_t>(1, std::min<size_t>(threads * 8, text.size() / MIN_CHUNK));
+    std::vector<std::string_view> chunks;
+    size_t begin = 0;
+    for (size_t c = 1; c <= chunk_count && begin < text.size(); ++c)
+    {
+        size_t end = c == chunk_count ? text.size() : std::max(begin, text.size() * c / chunk_count);
+        if (end < text.size())
+        {
+            const void *newline = std::memchr(text.data() + end, '\n', text.size() - end);
+            end = newline == nullptr ? text.size() : static_cast<const char *>(newline) - text.data() + 1;
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    std::vector<std::vector<Person>> parsed(chunks.size());
+    std::vector<std::exception_ptr> errors(chunks.size());
+    person_parser::for_each_chunk(chunks.size(), threads, [&](size_t c)
+                                  {
+                                      try
+                                      {
+                                          parse_people(chunks[c], parsed[c]);
+                                      }
+                                      catch (...)
+                                      {
+                                          errors[c] = std::current_exception();
+                                      } });
+    for (const std::exception_ptr &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error); // the first one in file order
+        }
+    }
+    if (parsed.size() == 1)
+    {
+        return std::move(parsed[0]);
+    }
+
+    // Merge in order: every chunk knows where it starts, so the moves run in parallel too.
+    std::vector<size_t> first(parsed.size() + 1, 0);
+    for (size_t c = 0; c < parsed.size(); ++c)
+    {
+        first[c + 1] = first[c] + parsed[c].size();
+    }
+    std::vector<Person> people(first.back());
+    person_parser::for_each_chunk(parsed.size(), threads, [&](size_t c)
+                                  {
+                                      std::move(parsed[c].begin(), parsed[c].end(), people.begin() + first[c]);
+                                      std::vector<Person>().swap(parsed[c]); });
+    return people;
+}
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include "mapped_file.h"
+
+// Appends records to a file without making the caller wait for the disk.
+//
+// append() copies the record into the current page (a large in-memory buffer)
+// and returns. A full page goes to a background I/O thread and the caller keeps
+// filling the next one; with the default two pages that is double buffering.
+// Only when every page is waiting for the disk does append() block.
+//
+// barrier() is the durability point: it returns once everything appended
+// before it is on disk (fdatasync'ed). The I/O thread writes all pages that are
+// ready in one batch and syncs once per batch, so many barriers from many
+// threads share one fdatasync (group commit).
+//
+//     AsyncRecordWriter log("people.log");
+//     log.append("Alice 30\n");    // from any thread
+//     log.barrier();               // Alice is on disk now
+//
+// Options::sync picks when to fdatasync:
+//   OnBarrier  - only for batches that a barrier() waits for (default)
+//   EveryBatch - after every batch, even without barrier()
+//   Never      - barrier() only waits for write(); the data may still be in
+//                the page cache (for benchmarks)
+//
+// Options::direct_io opens the file with O_DIRECT, so pages bypass the page
+// cache. Pages are then 4 KB aligned, and a partial page is written padded to
+// 4 KB and truncated back. If the file system refuses O_DIRECT, the writer
+// falls back to normal writes (is_direct() tells).
+
+class AsyncRecordWriter
+{
+public:
+    enum class SyncPolicy
+    {
+        OnBarrier,
+        EveryBatch,
+        Never
+    };
+
+    struct Options
+    {
+        size_t page_size = 1 << 20;
+        size_t pages = 2;
+        SyncPolicy sync = SyncPolicy::OnBarrier;
+        bool direct_io = false;
+    };
+
+private:
+    static constexpr size_t BLOCK = 4096; // O_DIRECT alignment
+
+    struct Page
+    {
+        char *data = nullptr;
+        size_t used = 0;
+        uint64_t file_offset = 0; // where data[0] goes
+    };
+
+    int fd = -1;
+    bool direct = false;
+    Options options;
+    std::vector<Page> pages;
+
+    std::mutex append_mtx; // one record at a time, so records are never interleaved
+    std::mutex mtx;
+    std::condition_variable page_free;   // an append() waits for a page
+    std::condition_variable work;        // the I/O thread waits for pages or a sync
+    std::condition_variable durable_now; // barrier() waits for durable_end
+    std::vector<Page *> free_pages;
+    std::deque<Page *> full_pages;
+    Page *current = nullptr;     // nullptr while waiting for a free page
+    uint64_t next_offset = 0;    // file offset of the next page
+    const char *carry = nullptr; // bytes the next page starts with (O_DIRECT)
+    size_t carry_size = 0;
+    uint64_t end = 0;         // bytes appended so far
+    uint64_t written_end = 0; // bytes written by the I/O thread
+    uint64_t durable_end = 0; // bytes that barrier() may consider durable
+    bool sync_requested = false;
+    bool stopping = false;
+    std::exception_ptr error;
+    std::thread io_thread;
+
+    void throw_if_failed()
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Makes sure there is a current page; waits if all pages are being written.
+    void wait_for_page(std::unique_lock<std::mutex> &lock)
+    {
+        page_free.wait(lock, [this]()
+                       { return current != nullptr || !free_pages.empty() || error; });
+        throw_if_failed();
+        if (current == nullptr)
+        {
+            current = free_pages.back();
+            free_pages.pop_back();
+            current->file_offset = next_offset;
+            if (carry_size > 0)
+            {
+                std::memmove(current->data, carry, carry_size);
+            }
+            current->used = carry_size;
+            page_free.notify_all(); // other appenders waiting for a page can go on
+        }
+    }
+
+    // Gives the current page (full, or partial for a barrier) to the I/O thread.
+    void hand_over(std::unique_lock<std::mutex> &lock, bool partial)
+    {
+        full_pages.push_back(current);
+        work.notify_one();
+        next_offset = current->file_offset + current->used;
+        carry_size = 0;
+        if (direct && partial)
+        {
+            // The next write has to start on a block boundary, so the next page
+            // starts with the unfinished block of this one.
+            carry_size = current->used % BLOCK;
+            carry = current->data + current->used - carry_size;
+            next_offset -= carry_size;
+        }
+        current = nullptr;
+        wait_for_page(lock);
+    }
+
+    void write_page(const Page &page)
+    {
+        size_t length = page.used;
+        if (direct)
+        {
+            length = (length + BLOCK - 1) / BLOCK * BLOCK;
+            std::memset(page.data + page.used, 0, length - page.used);
+        }
+        size_t written = 0;
+        while (written < length)
+        {
+            ssize_t count = ::pwrite(fd, page.data + written, length - written,
+                                     static_cast<off_t>(page.file_offset + written));
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw system_error_for("Failed to write records");
+            }
+            written += static_cast<size_t>(count);
+        }
+        if (length != page.used && ::ftruncate(fd, static_cast<off_t>(page.file_offset + page.used)) != 0)
+        {
+            throw system_error_for("Failed to truncate record file");
+        }
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true)
+        {
+            work.wait(lock, [this]()
+                      { return !full_pages.empty() || sync_requested || stopping; });
+            if (full_pages.empty() && !sync_requested)
+            {
+                return; // stopping, and everything has been written
+            }
+
+            // Everything that is ready goes out in one batch with one sync.
+            std::vector<Page *> batch(full_pages.begin(), full_pages.end());
+            full_pages.clear();
+            bool sync = options.sync == SyncPolicy::EveryBatch ||
+                        (options.sync == SyncPolicy::OnBarrier && sync_requested);
+            sync_requested = false;
+            uint64_t batch_end = batch.empty() ? written_end : batch.back()->file_offset + batch.back()->used;
+            lock.unlock();
+
+            try
+            {
+                for (Page *page : batch)
+                {
+                    write_page(*page);
+                }
+                if (sync && ::fdatasync(fd) != 0)
+                {
+                    throw system_error_for("Failed to sync records");
+                }
+            }
+            catch (...)
+            {
+                lock.lock();
+                error = std::current_exception();
+                page_free.notify_all();
+                durable_now.notify_all();
+                return;
+            }
+
+            lock.lock();
+            free_pages.insert(free_pages.end(), batch.begin(), batch.end());
+            page_free.notify_all();
+            written_end = batch_end;
+            // Without a sync, data is only durable if the policy says not to care.
+            if (sync || options.sync == SyncPolicy::Never)
+            {
+                durable_end = std::max(durable_end, batch_end);
+                durable_now.notify_all();
+            }
+        }
+    }
+
+public:
+    explicit AsyncRecordWriter(const std::string &filename) : AsyncRecordWriter(filename, Options()) {}
+
+    AsyncRecordWriter(const std::string &filename, const Options &options) : options(options)
+    {
+        if (this->options.pages < 2)
+        {
+            throw std::invalid_argument("AsyncRecordWriter needs at least two pages");
+        }
+        if (options.direct_io)
+        {
+            fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+            direct = fd >= 0;
+            this->options.page_size = std::max(BLOCK, (options.page_size + BLOCK - 1) / BLOCK * BLOCK);
+        }
+        if (fd < 0)
+        {
+            fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        }
+        if (fd < 0)
+        {
+            throw system_error_for("Unable to open file for writing: " + filename);
+        }
+
+        pages.resize(this->options.pages);
+        for (Page &page : pages)
+        {
+            void *memory = nullptr;
+            if (::posix_memalign(&memory, BLOCK, this->options.page_size) != 0)
+            {
+                for (Page &allocated : pages)
+                {
+                    std::free(allocated.data);
+                }
+                ::close(fd);
+                throw std::bad_alloc();
+            }
+            page.data = static_cast<char *>(memory);
+            free_pages.push_back(&page);
+        }
+        io_thread = std::thread(&AsyncRecordWriter::run, this);
+    }
+
+    AsyncRecordWriter(const AsyncRecordWriter &) = delete;
+    AsyncRecordWriter &operator=(const AsyncRecordWriter &) = delete;
+
+    ~AsyncRecordWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (const std::exception &)
+        {
+            // Call close() yourself to see write errors.
+        }
+        for (Page &page : pages)
+        {
+            std::free(page.data);
+        }
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+
+    // Copies the record; returns the file offset just past it. A record that
+    // spans pages is still written whole: the next append() waits until it is
+    // copied, even while this one waits for a free page.
+    uint64_t append(std::string_view record)
+    {
+        std::lock_guard<std::mutex> record_lock(append_mtx);
+        std::unique_lock<std::mutex> lock(mtx);
+        throw_if_failed();
+        if (stopping)
+        {
+            throw std::logic_error("AsyncRecordWriter is closed");
+        }
+        if (record.empty())
+        {
+            return end;
+        }
+        while (!record.empty())
+        {
+            wait_for_page(lock);
+            size_t count = std::min(record.size(), options.page_size - current->used);
+            std::memcpy(current->data + current->used, record.data(), count);
+            current->used += count;
+            record.remove_prefix(count);
+            if (current->used == options.page_size)
+            {
+                hand_over(lock, false);
+            }
+        }
+        end = current->file_offset + current->used;
+        return end;
+    }
+
+    // Waits until everything appended so far is durable (see SyncPolicy).
+    void barrier()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        throw_if_failed();
+        uint64_t target = end;
+        if (durable_end >= target)
+        {
+            return;
+        }
+        wait_for_page(lock);
+        if (current->used > carry_size) // more than what the last partial page already wrote
+        {
+            hand_over(lock, true);
+        }
+        sync_requested = true;
+        work.notify_one();
+        durable_now.wait(lock, [this, target]()
+                         { return durable_end >= target || error; });
+        throw_if_failed();
+    }
+
+    // barrier(), then stops the I/O thread. Nothing can be appended afterwards.
+    void close()
+    {
+        if (!io_thread.joinable())
+        {
+            return;
+        }
+        std::exception_ptr failure;
+        try
+        {
+            barrier();
+        }
+        catch (...)
+        {
+            failure = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        work.notify_one();
+        io_thread.join();
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    bool is_direct() const
+    {
+        return direct;
+    }
+};
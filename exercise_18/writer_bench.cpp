@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include "mapped_file.h"
+#include "person.h"
+#include "record_writer.h"
+
+// Writes people as text lines (the format of writePeopleToFile), first with an
+// ofstream as fstream2.cpp does (<< std::endl, then '\n'), then from several
+// threads through AsyncRecordWriter with each sync policy. Reports records per
+// second and the p50/p99 time a single write/append call takes. After each
+// AsyncRecordWriter run the file is read back to check that every record is
+// there exactly once and in one piece. The output goes to writer_bench.txt and
+// writer_bench.log in the current directory (so O_DIRECT is tried on a real
+// file system), which are deleted after each run.
+//
+// Usage: writer_bench [records per thread] [threads]
+
+typedef std::chrono::steady_clock Clock;
+
+static const char *TEXT_FILE = "writer_bench.txt";
+static const char *LOG_FILE = "writer_bench.log";
+
+// Formats "name age\n" into out without allocating; returns its length.
+size_t serialize(const Person &p, char *out)
+{
+    std::copy(p.name.begin(), p.name.end(), out);
+    size_t length = p.name.size();
+    out[length++] = ' ';
+    length = std::to_chars(out + length, out + length + 16, p.age).ptr - out;
+    out[length++] = '\n';
+    return length;
+}
+
+struct Result
+{
+    std::vector<int64_t> latencies; // one sample per 16 records
+    size_t bytes = 0;
+};
+
+template <typename Write>
+void time_records(Result &result, long records, long first, Write write)
+{
+    result.latencies.reserve(records / 16 + 1);
+    for (long i = 0; i < records; ++i)
+    {
+        Person p("Person" + std::to_string(first + i), static_cast<int>(i % 100));
+        Clock::time_point start = Clock::now();
+        result.bytes += write(p);
+        if (i % 16 == 0)
+        {
+            result.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        }
+    }
+}
+
+void report(const char *name, std::vector<Result> &results, long records, double seconds, const std::string &filename)
+{
+    std::vector<int64_t> all;
+    size_t bytes = 0;
+    for (Result &result : results)
+    {
+        all.insert(all.end(), result.latencies.begin(), result.latencies.end());
+        bytes += result.bytes;
+    }
+    std::sort(all.begin(), all.end());
+    struct stat info;
+    if (::stat(filename.c_str(), &info) != 0 || static_cast<size_t>(info.st_size) != bytes)
+    {
+        std::cerr << name << ": expected " << bytes << " bytes in " << filename << std::endl;
+        std::exit(1);
+    }
+    std::printf("%-22s %8.2f M records/s   call p50 %7lld ns  p99 %8lld ns\n", name, records / seconds / 1e6,
+                static_cast<long long>(all[all.size() / 2]), static_cast<long long>(all[all.size() * 99 / 100]));
+}
+
+// Thread t wrote "Person<n> <age>" for n in [t * records, (t + 1) * records)
+// with age (n - t * records) % 100.
+void verify_lines(const char *name, const std::string &filename, long total, long records)
+{
+    std::vector<char> seen(total, 0);
+    LineReader reader(filename);
+    std::string_view line;
+    long lines = 0;
+    while (reader.next(line))
+    {
+        long n = -1;
+        int age = -1;
+        size_t space = line.find(' ');
+        bool ok = line.substr(0, 6) == "Person" && space != std::string_view::npos &&
+                  std::from_chars(line.data() + 6, line.data() + space, n).ptr == line.data() + space &&
+                  std::from_chars(line.data() + space + 1, line.data() + line.size(), age).ptr ==
+                      line.data() + line.size() &&
+                  n >= 0 && n < total && !seen[n] && age == (n % records) % 100;
+        if (!ok)
+        {
+            std::cerr << name << ": bad or repeated record in " << filename << ": " << line << std::endl;
+            std::exit(1);
+        }
+        seen[n] = 1;
+        ++lines;
+    }
+    if (lines != total)
+    {
+        std::cerr << name << ": " << lines << " records in " << filename << " instead of " << total << std::endl;
+        std::exit(1);
+    }
+}
+
+void run_ofstream(const char *name, long records, bool endl)
+{
+    std::vector<Result> results(1);
+    Clock::time_point start = Clock::now();
+    {
+        std::ofstream file(TEXT_FILE);
+        time_records(results[0], records, 0, [&](const Person &p)
+                     {
+                         if (endl)
+                         {
+                             file << p << std::endl;
+                         }
+                         else
+                         {
+                             file << p << '\n';
+                         }
+                         return p.name.size() + std::to_string(p.age).size() + 2; });
+    }
+    report(name, results, records, std::chrono::duration<double>(Clock::now() - start).count(), TEXT_FILE);
+    std::remove(TEXT_FILE);
+}
+
+void run_async(const char *name, int threads, long records, AsyncRecordWriter::Options options, long barrier_every)
+{
+    std::vector<Result> results(threads);
+    Clock::time_point start = Clock::now();
+    {
+        AsyncRecordWriter writer(LOG_FILE, options);
+        if (options.direct_io && !writer.is_direct())
+        {
+            std::printf("%-22s (O_DIRECT not supported here, using buffered writes)\n", name);
+        }
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]()
+                                 {
+                                     char line[64];
+                                     long appended = 0;
+                                     time_records(results[t], records, t * records, [&](const Person &p)
+                                                  {
+                                                      size_t length = serialize(p, line);
+                                                      writer.append(std::string_view(line, length));
+                                                      if (barrier_every != 0 && ++appended % barrier_every == 0)
+                                                      {
+                                                          writer.barrier();
+                                                      }
+                                                      return length; }); });
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        writer.close();
+    }
+    report(name, results, threads * records, std::chrono::duration<double>(Clock::now() - start).count(), LOG_FILE);
+    verify_lines(name, LOG_FILE, threads * records, records);
+    std::remove(LOG_FILE);
+}
+
+int main(int argc, char *argv[])
+{
+    long records = argc > 1 ? std::atol(argv[1]) : 1000000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 4;
+
+    try
+    {
+        run_ofstream("ofstream << endl", records, true);
+        run_ofstream("ofstream << '\\n'", records, false);
+
+        AsyncRecordWriter::Options options;
+        options.sync = AsyncRecordWriter::SyncPolicy::Never;
+        run_async("async, no sync", threads, records, options, 0);
+
+        options.sync = AsyncRecordWriter::SyncPolicy::OnBarrier;
+        run_async("async, barrier/10000", threads, records, options, 10000);
+
+        options.sync = AsyncRecordWriter::SyncPolicy::EveryBatch;
+        run_async("async, group commit", threads, records, options, 0);
+
+        options.direct_io = true;
+        run_async("async, O_DIRECT", threads, records, options, 10000);
+
+        // Small pages: many records span two pages, and appenders wait for pages.
+        options.page_size = 8192;
+        options.pages = 3;
+        run_async("async, O_DIRECT, 8 KB", threads, records, options, 10000);
+        options.direct_io = false;
+        run_async("async, 8 KB pages", threads, records, options, 10000);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
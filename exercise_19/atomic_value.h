@@ -0,0 +1,302 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "backoff.h"
+
+// A value of type T that many threads can read and update. The implementation is
+// chosen at compile time from the shape of T:
+//
+//   FetchAdd - T is an integer, or a type that is "an integer in a wrapper"
+//              (see arithmetic_representation below). Increments are a single
+//              fetch_add instead of a retry loop.
+//   Cas      - any other trivially copyable T that std::atomic handles without a
+//              lock. update() is a compare_exchange loop with exponential backoff.
+//   SeqLock  - larger trivially copyable T. Readers never write shared memory and
+//              retry if a writer was active; writers take turns.
+//
+//     AtomicValue<int> hits;
+//     hits.fetch_add(1);
+//     AtomicValue<Stats> stats;
+//     stats.update([](Stats &s) { ++s.count; });
+//     Stats copy = stats.load();
+
+// Specialize for a trivially copyable wrapper whose only member is an integer,
+// so AtomicValue<T> can use fetch_add on it:
+//     template <>
+//     struct arithmetic_representation<Counter> { typedef int type; };
+template <typename T, typename Enable = void>
+struct arithmetic_representation
+{
+};
+
+template <typename T>
+struct arithmetic_representation<T, typename std::enable_if<std::is_integral<T>::value>::type>
+{
+    typedef T type;
+};
+
+namespace atomic_value_detail
+{
+    template <typename T, typename = void>
+    struct has_representation : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct has_representation<T, std::void_t<typename arithmetic_representation<T>::type>> : std::true_type
+    {
+    };
+}
+
+enum class AtomicStrategy
+{
+    FetchAdd,
+    Cas,
+    SeqLock
+};
+
+template <typename T>
+constexpr AtomicStrategy default_atomic_strategy()
+{
+    if constexpr (atomic_value_detail::has_representation<T>::value)
+    {
+        return AtomicStrategy::FetchAdd;
+    }
+    else if constexpr (std::atomic<T>::is_always_lock_free)
+    {
+        return AtomicStrategy::Cas;
+    }
+    else
+    {
+        return AtomicStrategy::SeqLock;
+    }
+}
+
+template <typename T, AtomicStrategy STRATEGY = default_atomic_strategy<T>()>
+class AtomicValue;
+
+template <typename T>
+class AtomicValue<T, AtomicStrategy::FetchAdd>
+{
+private:
+    typedef typename arithmetic_representation<T>::type Integer;
+
+    static_assert(std::is_trivially_copyable<T>::value && sizeof(T) == sizeof(Integer),
+                  "arithmetic_representation<T>::type must have the same size as T");
+
+    std::atomic<Integer> value;
+
+    static Integer to_integer(const T &from)
+    {
+        Integer to;
+        std::memcpy(static_cast<void *>(&to), &from, sizeof(to));
+        return to;
+    }
+
+    static T from_integer(Integer from)
+    {
+        T to;
+        std::memcpy(static_cast<void *>(&to), &from, sizeof(to));
+        return to;
+    }
+
+public:
+    static constexpr AtomicStrategy strategy = AtomicStrategy::FetchAdd;
+    static constexpr bool is_always_lock_free = std::atomic<Integer>::is_always_lock_free;
+
+    AtomicValue() : value(to_integer(T())) {}
+    explicit AtomicValue(const T &initial) : value(to_integer(initial)) {}
+
+    T load() const
+    {
+        return from_integer(value.load(std::memory_order_acquire));
+    }
+
+    void store(const T &new_value)
+    {
+        value.store(to_integer(new_value), std::memory_order_release);
+    }
+
+    // Adds delta to the underlying integer and returns the previous value.
+    T fetch_add(Integer delta, std::memory_order order = std::memory_order_acq_rel)
+    {
+        return from_integer(value.fetch_add(delta, order));
+    }
+
+    // Applies function to a copy and publishes the result; returns the new value.
+    template <typename Function>
+    T update(Function function)
+    {
+        Integer current = value.load(std::memory_order_relaxed);
+        Backoff backoff;
+        while (true)
+        {
+            T next = from_integer(current);
+            function(next);
+            if (value.compare_exchange_weak(current, to_integer(next), std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                return next;
+            }
+            backoff.pause();
+        }
+    }
+};
+
+template <typename T>
+class AtomicValue<T, AtomicStrategy::Cas>
+{
+private:
+    std::atomic<T> value;
+
+public:
+    static constexpr AtomicStrategy strategy = AtomicStrategy::Cas;
+    static constexpr bool is_always_lock_free = std::atomic<T>::is_always_lock_free;
+
+    AtomicValue() : value(T()) {}
+    explicit AtomicValue(const T &initial) : value(initial) {}
+
+    T load() const
+    {
+        return value.load(std::memory_order_acquire);
+    }
+
+    void store(const T &new_value)
+    {
+        value.store(new_value, std::memory_order_release);
+    }
+
+    template <typename Function>
+    T update(Function function)
+    {
+        T current = value.load(std::memory_order_relaxed);
+        Backoff backoff;
+        while (true)
+        {
+            T next = current;
+            function(next);
+            if (value.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                return next;
+            }
+            backoff.pause();
+        }
+    }
+};
+
+// The value is kept in relaxed atomic words, so a reader that races with a writer
+// reads torn data (and retries) instead of causing a data race.
+template <typename T>
+class AtomicValue<T, AtomicStrategy::SeqLock>
+{
+private:
+    static_assert(std::is_trivially_copyable<T>::value, "AtomicValue<T> needs a trivially copyable T");
+
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // Even: no writer. Odd: a writer is updating the words.
+    alignas(64) std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> words[WORDS];
+
+    void read_words(T &to) const
+    {
+        uint64_t buffer[WORDS];
+        for (size_t i = 0; i < WORDS; ++i)
+        {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+        std::memcpy(static_cast<void *>(&to), buffer, sizeof(T));
+    }
+
+    void write_words(const T &from)
+    {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &from, sizeof(T));
+        for (size_t i = 0; i < WORDS; ++i)
+        {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t lock()
+    {
+        uint64_t current = sequence.load(std::memory_order_relaxed);
+        Backoff backoff;
+        while (true)
+        {
+            if ((current & 1) == 0 &&
+                sequence.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                // Orders the odd sequence before the data writes that follow.
+                std::atomic_thread_fence(std::memory_order_release);
+                return current + 1;
+            }
+            backoff.pause();
+            current = sequence.load(std::memory_order_relaxed);
+        }
+    }
+
+    void unlock(uint64_t locked)
+    {
+        sequence.store(locked + 1, std::memory_order_release);
+    }
+
+public:
+    static constexpr AtomicStrategy strategy = AtomicStrategy::SeqLock;
+    static constexpr bool is_always_lock_free = false; // writers wait for each other
+
+    AtomicValue()
+    {
+        write_words(T());
+    }
+
+    explicit AtomicValue(const T &initial)
+    {
+        write_words(initial);
+    }
+
+    AtomicValue(const AtomicValue &) = delete;
+    AtomicValue &operator=(const AtomicValue &) = delete;
+
+    T load() const
+    {
+        T result;
+        Backoff backoff;
+        while (true)
+        {
+            uint64_t before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0)
+            {
+                read_words(result);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before)
+                {
+                    return result;
+                }
+            }
+            backoff.pause();
+        }
+    }
+
+    void store(const T &new_value)
+    {
+        uint64_t locked = lock();
+        write_words(new_value);
+        unlock(locked);
+    }
+
+    template <typename Function>
+    T update(Function function)
+    {
+        uint64_t locked = lock();
+        T next;
+        read_words(next);
+        function(next);
+        write_words(next);
+        unlock(locked);
+        return next;
+    }
+};
@@ -0,0 +1,149 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "atomic_value.h"
+
+// Contention benchmark for the Counter increment from atomic2.cpp. Compares:
+//   cas loop    - std::atomic<Counter> with a bare compare_exchange_weak loop (atomic2.cpp)
+//   backoff     - AtomicValue<Counter, Cas>: the same loop with exponential backoff
+//   fetch_add   - AtomicValue<Counter>: a single fetch_add on the wrapped int
+// and, for a 32-byte Stats type that std::atomic cannot handle without a lock:
+//   mutex       - std::mutex around the update
+//   seqlock     - AtomicValue<Stats>
+//
+// Usage: atomic_value_bench [increments per thread] [max threads]
+
+class Counter
+{
+public:
+    Counter() : value(0) {}
+    int get() const { return value; }
+    void increment() { ++value; }
+
+private:
+    int value;
+};
+
+template <>
+struct arithmetic_representation<Counter>
+{
+    typedef int type;
+};
+
+struct Stats
+{
+    long long count;
+    long long sum;
+    long long min;
+    long long max;
+};
+
+static void add_sample(Stats &stats, long long sample)
+{
+    stats.min = stats.count == 0 || sample < stats.min ? sample : stats.min;
+    stats.max = stats.count == 0 || sample > stats.max ? sample : stats.max;
+    ++stats.count;
+    stats.sum += sample;
+}
+
+static_assert(AtomicValue<Counter>::strategy == AtomicStrategy::FetchAdd, "Counter should use fetch_add");
+static_assert(AtomicValue<Counter>::is_always_lock_free, "Counter increments should be lock-free");
+static_assert(AtomicValue<Stats>::strategy == AtomicStrategy::SeqLock, "Stats should use the seqlock");
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Increment>
+double run(int threads, long increments, Increment increment)
+{
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]()
+                             {
+                                 while (!go.load(std::memory_order_acquire))
+                                 {
+                                     std::this_thread::yield();
+                                 }
+                                 for (long i = 0; i < increments; ++i)
+                                 {
+                                     increment(i);
+                                 } });
+    }
+    Clock::time_point start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return threads * increments / seconds / 1e6;
+}
+
+static void check(const char *name, long long value, long long expected)
+{
+    if (value != expected)
+    {
+        std::fprintf(stderr, "%s: counted %lld, expected %lld\n", name, value, expected);
+        std::exit(1);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    long increments = argc > 1 ? std::atol(argv[1]) : 1000000;
+    int max_threads = argc > 2 ? std::atoi(argv[2]) : 16;
+
+    std::printf("%ld increments per thread, M increments/s\n", increments);
+    std::printf("%8s %12s %12s %12s %12s %12s\n", "threads", "cas loop", "backoff", "fetch_add", "mutex", "seqlock");
+
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        long long expected = static_cast<long long>(threads) * increments;
+
+        std::atomic<Counter> shared_counter;
+        double cas_rate = run(threads, increments, [&](long)
+                              {
+                                  Counter current = shared_counter.load();
+                                  Counter new_value;
+                                  do
+                                  {
+                                      new_value = current;
+                                      new_value.increment();
+                                  } while (!shared_counter.compare_exchange_weak(current, new_value)); });
+        check("cas loop", shared_counter.load().get(), expected);
+
+        AtomicValue<Counter, AtomicStrategy::Cas> backoff_counter;
+        double backoff_rate = run(threads, increments, [&](long)
+                                  { backoff_counter.update([](Counter &counter)
+                                                           { counter.increment(); }); });
+        check("backoff", backoff_counter.load().get(), expected);
+
+        AtomicValue<Counter> fetch_add_counter;
+        double fetch_add_rate = run(threads, increments, [&](long)
+                                    { fetch_add_counter.fetch_add(1); });
+        check("fetch_add", fetch_add_counter.load().get(), expected);
+
+        std::mutex mtx;
+        Stats locked_stats = {};
+        double mutex_rate = run(threads, increments, [&](long i)
+                                {
+                                    std::lock_guard<std::mutex> lock(mtx);
+                                    add_sample(locked_stats, i); });
+        check("mutex", locked_stats.count, expected);
+
+        AtomicValue<Stats> seqlock_stats;
+        double seqlock_rate = run(threads, increments, [&](long i)
+                                  { seqlock_stats.update([i](Stats &stats)
+                                                         { add_sample(stats, i); }); });
+        check("seqlock", seqlock_stats.load().count, expected);
+
+        std::printf("%8d %12.1f %12.1f %12.1f %12.1f %12.1f\n", threads, cas_rate, backoff_rate, fetch_add_rate, mutex_rate, seqlock_rate);
+    }
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <thread>
+
+// Tells the CPU this is a spin-wait loop (lower power, and on x86 it stops the
+// spinning thread from starving its hyper-threaded sibling).
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+// Exponential backoff for retry loops: each pause() spins twice as long as the
+// previous one, and once MAX_SPINS is reached it yields to the scheduler instead.
+// Backing off spreads out the retries of threads that collided on a CAS, so they
+// don't all collide again.
+class Backoff
+{
+private:
+    static constexpr unsigned MAX_SPINS = 1024;
+    unsigned spins = 1;
+
+public:
+    void pause()
+    {
+        if (spins <= MAX_SPINS)
+        {
+            for (unsigned i = 0; i < spins; ++i)
+            {
+                cpu_relax();
+            }
+            spins *= 2;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // True once pause() has started yielding instead of spinning.
+    bool is_yielding() const
+    {
+        return spins > MAX_SPINS;
+    }
+
+    void reset()
+    {
+        spins = 1;
+    }
+};
@@ -0,0 +1,593 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Promise/Future pair whose results can be chained without blocking:
+//
+//     Future<int> sum = run_on(pool, calculate_sum, 10, 20);
+//     Future<std::string> text = sum.then([](int value) { return std::to_string(value); });
+//     Future<std::vector<int>> all = when_all(std::move(sums));
+//
+// then(function) runs function on the thread that completes the future (or right
+// away if it already is complete); then(executor, function) posts it to an
+// executor instead, i.e. anything with a post(callable) member such as
+// ThreadPool. The executor must outlive the chain.
+//
+// A continuation gets the value, or (if it takes a Future<T>) the completed future
+// itself. When the future holds an exception, value continuations are skipped and
+// the exception travels down the chain to get() or to the first continuation
+// that takes a Future<T>. A continuation that returns a Future<U> is unwrapped:
+// then() gives a Future<U>, not a Future<Future<U>>.
+//
+// Futures are shared handles (like std::shared_future): copies refer to the same
+// result, and get() returns a copy of the value. get() therefore needs a
+// copyable T; a move-only value is read through then(), or when_all() /
+// when_any(), which move it out of the future. when_all() also takes a vector
+// of Future<void>; the tuple form does not accept Future<void> inputs.
+
+template <typename T>
+class Future;
+
+template <typename T>
+class Promise;
+
+// Runs posted work right away on the calling thread.
+struct InlineExecutor
+{
+    template <typename Function>
+    void post(Function &&function)
+    {
+        function();
+    }
+};
+
+namespace future_detail
+{
+    struct Unit
+    {
+    };
+
+    template <typename T>
+    using Stored = typename std::conditional<std::is_void<T>::value, Unit, T>::type;
+
+    template <typename T>
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable completed;
+        bool ready = false;
+        std::optional<Stored<T>> value;
+        std::exception_ptr exception;
+        std::vector<std::function<void()>> continuations;
+
+        // Stores the result unless one is already there; runs the continuations.
+        template <typename Set>
+        bool try_complete(Set set)
+        {
+            std::vector<std::function<void()>> to_run;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (ready)
+                {
+                    return false;
+                }
+                set();
+                ready = true;
+                to_run.swap(continuations);
+            }
+            completed.notify_all();
+            for (std::function<void()> &continuation : to_run)
+            {
+                continuation();
+            }
+            return true;
+        }
+
+        bool try_set_value(Stored<T> &&new_value)
+        {
+            return try_complete([&]()
+                                { value.emplace(std::move(new_value)); });
+        }
+
+        bool try_set_exception(std::exception_ptr new_exception)
+        {
+            return try_complete([&]()
+                                { exception = new_exception; });
+        }
+
+        // Runs continuation once the result is set (right away if it already is).
+        void on_complete(std::function<void()> continuation)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!ready)
+                {
+                    continuations.push_back(std::move(continuation));
+                    return;
+                }
+            }
+            continuation();
+        }
+    };
+
+    template <typename T>
+    struct is_future : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct is_future<Future<T>> : std::true_type
+    {
+    };
+
+    template <typename R>
+    struct unwrap
+    {
+        typedef R type;
+    };
+
+    template <typename U>
+    struct unwrap<Future<U>>
+    {
+        typedef U type;
+    };
+
+    // What a continuation for Future<T> is called with: the future, or the value.
+    template <typename T, typename Function>
+    constexpr bool takes_future()
+    {
+        return std::is_invocable<Function, Future<T>>::value;
+    }
+
+    template <typename T, typename Function>
+    struct continuation_result
+    {
+        typedef typename std::invoke_result<Function, const T &>::type type;
+    };
+
+    template <typename Function>
+    struct continuation_result<void, Function>
+    {
+        typedef typename std::invoke_result<Function>::type type;
+    };
+
+    template <typename T, typename Function>
+    using result_of = typename std::conditional<takes_future<T, Function>(),
+                                                std::invoke_result<Function, Future<T>>,
+                                                continuation_result<T, Function>>::type::type;
+
+    template <typename T>
+    const std::shared_ptr<State<T>> &state_of(const Future<T> &future)
+    {
+        return future.state;
+    }
+
+    // The value of a completed state, for forward() and when_all/when_any: a
+    // copy, so other handles to the same future still see it, or moved out if T
+    // can't be copied.
+    template <typename T>
+    T take_value(State<T> &state)
+    {
+        if constexpr (std::is_copy_constructible<T>::value)
+        {
+            return *state.value;
+        }
+        else
+        {
+            return std::move(*state.value);
+        }
+    }
+
+    // Passes a completed state's result on to promise.
+    template <typename T>
+    void forward(const std::shared_ptr<State<T>> &from, Promise<T> &to)
+    {
+        if (from->exception)
+        {
+            to.try_set_exception(from->exception);
+        }
+        else if constexpr (std::is_void<T>::value)
+        {
+            to.try_set_value();
+        }
+        else
+        {
+            to.try_set_value(take_value(*from));
+        }
+    }
+
+    // Calls call() and stores what it returns (or throws) in promise.
+    template <typename U, typename Call>
+    void deliver(Promise<U> &promise, Call call)
+    {
+        typedef typename std::invoke_result<Call>::type R;
+        try
+        {
+            if constexpr (is_future<R>::value)
+            {
+                R inner = call();
+                std::shared_ptr<State<U>> inner_state = state_of(inner);
+                inner_state->on_complete([inner_state, promise]() mutable
+                                         { forward(inner_state, promise); });
+            }
+            else if constexpr (std::is_void<R>::value)
+            {
+                call();
+                promise.try_set_value();
+            }
+            else
+            {
+                promise.try_set_value(call());
+            }
+        }
+        catch (...)
+        {
+            promise.try_set_exception(std::current_exception());
+        }
+    }
+}
+
+template <typename T>
+class Future
+{
+private:
+    std::shared_ptr<future_detail::State<T>> state;
+
+    explicit Future(std::shared_ptr<future_detail::State<T>> state) : state(std::move(state)) {}
+
+    template <typename>
+    friend class Promise;
+    template <typename U>
+    friend const std::shared_ptr<future_detail::State<U>> &future_detail::state_of(const Future<U> &);
+
+public:
+    Future() = default;
+
+    bool valid() const
+    {
+        return state != nullptr;
+    }
+
+    bool is_ready() const
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->ready;
+    }
+
+    void wait() const
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->completed.wait(lock, [this]()
+                              { return state->ready; });
+    }
+
+    // Blocks until the result is set; rethrows a stored exception.
+    T get() const
+    {
+        wait();
+        if (state->exception)
+        {
+            std::rethrow_exception(state->exception);
+        }
+        if constexpr (std::is_void<T>::value)
+        {
+            return;
+        }
+        else
+        {
+            return *state->value;
+        }
+    }
+
+    template <typename Executor, typename Function>
+    auto then(Executor &executor, Function function) -> Future<typename future_detail::unwrap<future_detail::result_of<T, Function>>::type>
+    {
+        typedef typename future_detail::unwrap<future_detail::result_of<T, Function>>::type U;
+        Promise<U> promise;
+        Future<U> result = promise.get_future();
+        std::shared_ptr<future_detail::State<T>> source = state;
+        state->on_complete([&executor, source, promise, function]()
+                           { executor.post([source, promise, function]() mutable
+                                           {
+                                               if constexpr (future_detail::takes_future<T, Function>())
+                                               {
+                                                   future_detail::deliver(promise, [&]()
+                                                                          { return function(Future<T>(source)); });
+                                               }
+                                               else if (source->exception)
+                                               {
+                                                   promise.try_set_exception(source->exception);
+                                               }
+                                               else if constexpr (std::is_void<T>::value)
+                                               {
+                                                   future_detail::deliver(promise, [&]()
+                                                                          { return function(); });
+                                               }
+                                               else
+                                               {
+                                                   future_detail::deliver(promise, [&]()
+                                                                          { return function(static_cast<const T &>(*source->value)); });
+                                               } }); });
+        return result;
+    }
+
+    template <typename Function>
+    auto then(Function function) -> Future<typename future_detail::unwrap<future_detail::result_of<T, Function>>::type>
+    {
+        static InlineExecutor inline_executor;
+        return then(inline_executor, std::move(function));
+    }
+};
+
+template <typename T>
+class Promise
+{
+private:
+    // Shared by all copies of a promise; when the last one goes away without a
+    // result, the future gets a broken_promise error (like std::promise).
+    struct Guard
+    {
+        std::shared_ptr<future_detail::State<T>> state;
+
+        explicit Guard(std::shared_ptr<future_detail::State<T>> state) : state(std::move(state)) {}
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+        ~Guard()
+        {
+            state->try_set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+    };
+
+    std::shared_ptr<future_detail::State<T>> state;
+    std::shared_ptr<Guard> guard;
+
+public:
+    Promise() : state(std::make_shared<future_detail::State<T>>()), guard(std::make_shared<Guard>(state))
+    {
+    }
+
+    Future<T> get_future() const
+    {
+        return Future<T>(state);
+    }
+
+    template <typename U = T>
+    bool try_set_value(typename std::enable_if<!std::is_void<U>::value, U>::type value)
+    {
+        return state->try_set_value(std::move(value));
+    }
+
+    template <typename U = T>
+    typename std::enable_if<std::is_void<U>::value, bool>::type try_set_value()
+    {
+        return state->try_set_value(future_detail::Unit());
+    }
+
+    bool try_set_exception(std::exception_ptr exception)
+    {
+        return state->try_set_exception(exception);
+    }
+
+    // Like try_set_*, but a second result is an error (as with std::promise).
+    template <typename... Value>
+    void set_value(Value &&...value)
+    {
+        if (!try_set_value(std::forward<Value>(value)...))
+        {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+    }
+
+    void set_exception(std::exception_ptr exception)
+    {
+        if (!try_set_exception(exception))
+        {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+    }
+};
+
+template <typename T>
+Future<typename std::decay<T>::type> make_ready_future(T &&value)
+{
+    Promise<typename std::decay<T>::type> promise;
+    promise.set_value(std::forward<T>(value));
+    return promise.get_future();
+}
+
+template <typename T>
+Future<T> make_exceptional_future(std::exception_ptr exception)
+{
+    Promise<T> promise;
+    promise.set_exception(exception);
+    return promise.get_future();
+}
+
+// Runs function(args...) on executor; the future holds its result.
+template <typename Executor, typename Function, typename... Args>
+auto run_on(Executor &executor, Function function, Args... args)
+    -> Future<typename future_detail::unwrap<typename std::invoke_result<Function, Args...>::type>::type>
+{
+    typedef typename future_detail::unwrap<typename std::invoke_result<Function, Args...>::type>::type U;
+    Promise<U> promise;
+    Future<U> result = promise.get_future();
+    executor.post([promise, function, args...]() mutable
+                  { future_detail::deliver(promise, [&]()
+                                           { return function(args...); }); });
+    return result;
+}
+
+// Completes with every value, in order, once all futures have completed; or with
+// the first exception as soon as any of them fails.
+template <typename T>
+Future<std::vector<T>> when_all(std::vector<Future<T>> futures)
+{
+    struct Shared
+    {
+        std::vector<std::optional<T>> values;
+        std::atomic<size_t> remaining;
+        Promise<std::vector<T>> promise;
+
+        explicit Shared(size_t count) : values(count), remaining(count) {}
+    };
+
+    std::shared_ptr<Shared> shared = std::make_shared<Shared>(futures.size());
+    Future<std::vector<T>> result = shared->promise.get_future();
+    if (futures.empty())
+    {
+        shared->promise.set_value(std::vector<T>());
+        return result;
+    }
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        std::shared_ptr<future_detail::State<T>> source = future_detail::state_of(futures[i]);
+        source->on_complete([shared, source, i]()
+                            {
+                                if (source->exception)
+                                {
+                                    shared->promise.try_set_exception(source->exception);
+                                    return;
+                                }
+                                shared->values[i] = future_detail::take_value(*source);
+                                if (shared->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                                {
+                                    std::vector<T> values;
+                                    values.reserve(shared->values.size());
+                                    for (std::optional<T> &value : shared->values)
+                                    {
+                                        values.push_back(std::move(*value));
+                                    }
+                                    shared->promise.try_set_value(std::move(values));
+                                } });
+    }
+    return result;
+}
+
+// Completes once all futures have completed; or with the first exception as
+// soon as any of them fails.
+inline Future<void> when_all(std::vector<Future<void>> futures)
+{
+    struct Shared
+    {
+        std::atomic<size_t> remaining;
+        Promise<void> promise;
+
+        explicit Shared(size_t count) : remaining(count) {}
+    };
+
+    std::shared_ptr<Shared> shared = std::make_shared<Shared>(futures.size());
+    Future<void> result = shared->promise.get_future();
+    if (futures.empty())
+    {
+        shared->promise.set_value();
+        return result;
+    }
+    for (const Future<void> &future : futures)
+    {
+        std::shared_ptr<future_detail::State<void>> source = future_detail::state_of(future);
+        source->on_complete([shared, source]()
+                            {
+                                if (source->exception)
+                                {
+                                    shared->promise.try_set_exception(source->exception);
+                                }
+                                else if (shared->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                                {
+                                    shared->promise.try_set_value();
+                                } });
+    }
+    return result;
+}
+
+namespace future_detail
+{
+    template <typename... Ts>
+    struct WhenAllTuple
+    {
+        std::tuple<std::optional<Ts>...> values;
+        std::atomic<size_t> remaining{sizeof...(Ts)};
+        Promise<std::tuple<Ts...>> promise;
+
+        template <size_t... I>
+        void finish(std::index_sequence<I...>)
+        {
+            promise.try_set_value(std::tuple<Ts...>(std::move(*std::get<I>(values))...));
+        }
+    };
+
+    template <size_t I, typename T, typename... Ts>
+    void watch(const std::shared_ptr<WhenAllTuple<Ts...>> &shared, const Future<T> &future)
+    {
+        std::shared_ptr<State<T>> source = state_of(future);
+        source->on_complete([shared, source]()
+                            {
+                                if (source->exception)
+                                {
+                                    shared->promise.try_set_exception(source->exception);
+                                    return;
+                                }
+                                std::get<I>(shared->values) = take_value(*source);
+                                if (shared->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                                {
+                                    shared->finish(std::index_sequence_for<Ts...>());
+                                } });
+    }
+
+    template <typename... Ts, size_t... I>
+    void watch_all(const std::shared_ptr<WhenAllTuple<Ts...>> &shared, std::index_sequence<I...>, const Future<Ts> &...futures)
+    {
+        (watch<I>(shared, futures), ...);
+    }
+}
+
+// Same for futures of different types: Future<std::tuple<A, B, ...>>.
+template <typename... Ts>
+Future<std::tuple<Ts...>> when_all(Future<Ts>... futures)
+{
+    std::shared_ptr<future_detail::WhenAllTuple<Ts...>> shared = std::make_shared<future_detail::WhenAllTuple<Ts...>>();
+    Future<std::tuple<Ts...>> result = shared->promise.get_future();
+    future_detail::watch_all(shared, std::index_sequence_for<Ts...>(), futures...);
+    return result;
+}
+
+// Completes with the index and value of the first future to complete (or with its
+// exception, if that one failed). Throws std::invalid_argument if there are none.
+template <typename T>
+Future<std::pair<size_t, T>> when_any(std::vector<Future<T>> futures)
+{
+    if (futures.empty())
+    {
+        throw std::invalid_argument("when_any: no futures to wait for");
+    }
+    Promise<std::pair<size_t, T>> promise;
+    Future<std::pair<size_t, T>> result = promise.get_future();
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        std::shared_ptr<future_detail::State<T>> source = future_detail::state_of(futures[i]);
+        source->on_complete([promise, source, i]() mutable
+                            {
+                                if (source->exception)
+                                {
+                                    promise.try_set_exception(source->exception);
+                                }
+                                else
+                                {
+                                    promise.try_set_value(std::pair<size_t, T>(i, future_detail::take_value(*source)));
+                                } });
+    }
+    return result;
+}
@@ -0,0 +1,101 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include "coroutine_task.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// future1.cpp's calculate_sum as a coroutine: the two-second "long calculation"
+// suspends the coroutine instead of blocking a thread.
+Task<int> calculate_sum(Scheduler &scheduler, int a, int b, CancellationToken token = CancellationToken())
+{
+    co_await scheduler.sleep_for(std::chrono::seconds(2), token); // Simulate long calculation
+    co_return a + b;
+}
+
+Task<void> add_sum(Scheduler &scheduler, int a, int b, std::atomic<long long> &total)
+{
+    total += co_await calculate_sum(scheduler, a, b);
+}
+
+Task<void> add_sum_or_count_cancelled(Scheduler &scheduler, int a, int b, CancellationToken token,
+                                      std::atomic<long long> &total, std::atomic<int> &cancelled)
+{
+    try
+    {
+        total += co_await calculate_sum(scheduler, a, b, token);
+    }
+    catch (const OperationCancelled &)
+    {
+        ++cancelled;
+    }
+}
+
+Task<void> cancel_after(Scheduler &scheduler, std::chrono::milliseconds delay, CancellationSource &source)
+{
+    co_await scheduler.sleep_for(delay);
+    source.cancel();
+}
+
+static double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main()
+{
+    const int CALCULATIONS = 10000;
+
+    {
+        SingleThreadScheduler scheduler;
+        std::cout << "Waiting for the result..." << std::endl;
+        std::cout << "Result: " << scheduler.block_on(calculate_sum(scheduler, 10, 20)) << std::endl;
+    }
+
+    {
+        // Thousands of calculations in flight on one thread.
+        SingleThreadScheduler scheduler;
+        std::atomic<long long> total{0};
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < CALCULATIONS; ++i)
+        {
+            scheduler.spawn(add_sum(scheduler, i, i, total));
+        }
+        scheduler.run();
+        std::cout << CALCULATIONS << " calculations on 1 thread: total " << total << " in "
+                  << seconds_since(start) << " s" << std::endl;
+    }
+
+    {
+        MultiThreadScheduler scheduler(4);
+        std::atomic<long long> total{0};
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < CALCULATIONS; ++i)
+        {
+            scheduler.spawn(add_sum(scheduler, i, i, total));
+        }
+        scheduler.wait_idle();
+        std::cout << CALCULATIONS << " calculations on 4 threads: total " << total << " in "
+                  << seconds_since(start) << " s" << std::endl;
+    }
+
+    {
+        // Half of the calculations listen to a source that is cancelled after 500 ms.
+        MultiThreadScheduler scheduler(4);
+        CancellationSource source;
+        std::atomic<long long> total{0};
+        std::atomic<int> cancelled{0};
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < CALCULATIONS; ++i)
+        {
+            CancellationToken token = i % 2 == 0 ? source.token() : CancellationToken();
+            scheduler.spawn(add_sum_or_count_cancelled(scheduler, i, i, token, total, cancelled));
+        }
+        scheduler.spawn(cancel_after(scheduler, std::chrono::milliseconds(500), source));
+        scheduler.wait_idle();
+        std::cout << cancelled << " of " << CALCULATIONS << " calculations cancelled, total of the rest "
+                  << total << " in " << seconds_since(start) << " s" << std::endl;
+    }
+
+    return 0;
+}
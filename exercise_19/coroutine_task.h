@@ -0,0 +1,729 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// C++20 coroutines for the exercise_19 examples (needs -std=c++20).
+//
+//     Task<int> calculate_sum(Scheduler &scheduler, int a, int b)
+//     {
+//         co_await scheduler.sleep_for(std::chrono::seconds(2)); // no thread is blocked
+//         co_return a + b;
+//     }
+//
+//     MultiThreadScheduler scheduler(4);
+//     int sum = scheduler.block_on(calculate_sum(scheduler, 10, 20));
+//
+// Task<T> is lazy: it starts when it is awaited (or spawned) and resumes its
+// awaiter when it finishes. Exceptions propagate to the awaiter.
+//
+// A scheduler keeps a queue of coroutines that are ready to run and a heap of
+// timers. SingleThreadScheduler runs them on the thread that calls run() or
+// block_on(); MultiThreadScheduler runs them on its own worker threads.
+//
+// Sleeps can be cancelled: pass a CancellationToken and the sleep ends early
+// with an OperationCancelled exception when its CancellationSource is cancelled.
+
+class OperationCancelled : public std::runtime_error
+{
+public:
+    OperationCancelled() : std::runtime_error("operation cancelled") {}
+};
+
+namespace coroutine_detail
+{
+    struct CancellationState
+    {
+        std::mutex mutex;
+        bool cancelled = false;
+        size_t next_id = 1;
+        std::map<size_t, std::function<void()>> callbacks;
+
+        // Calls callback on cancel() (now, if already cancelled). Returns an id
+        // for remove(), or 0 if the callback already ran.
+        size_t add(std::function<void()> callback)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!cancelled)
+                {
+                    callbacks.emplace(next_id, std::move(callback));
+                    return next_id++;
+                }
+            }
+            callback();
+            return 0;
+        }
+
+        void remove(size_t id)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            callbacks.erase(id);
+        }
+
+        void cancel()
+        {
+            std::map<size_t, std::function<void()>> to_run;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (cancelled)
+                {
+                    return;
+                }
+                cancelled = true;
+                to_run.swap(callbacks);
+            }
+            for (auto &callback : to_run)
+            {
+                callback.second();
+            }
+        }
+    };
+}
+
+// Read side of a cancellation flag; a default-constructed token is never cancelled.
+class CancellationToken
+{
+private:
+    std::shared_ptr<coroutine_detail::CancellationState> state;
+
+    friend class CancellationSource;
+    friend class SleepAwaiter;
+
+    explicit CancellationToken(std::shared_ptr<coroutine_detail::CancellationState> state) : state(std::move(state)) {}
+
+public:
+    CancellationToken() = default;
+
+    bool is_cancelled() const
+    {
+        if (!state)
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->cancelled;
+    }
+
+    // For cooperative checks inside long-running coroutines.
+    void throw_if_cancelled() const
+    {
+        if (is_cancelled())
+        {
+            throw OperationCancelled();
+        }
+    }
+};
+
+class CancellationSource
+{
+private:
+    std::shared_ptr<coroutine_detail::CancellationState> state = std::make_shared<coroutine_detail::CancellationState>();
+
+public:
+    CancellationToken token() const
+    {
+        return CancellationToken(state);
+    }
+
+    // Thread-safe; sleeps waiting on a token of this source end right away.
+    void cancel()
+    {
+        state->cancel();
+    }
+
+    bool is_cancelled() const
+    {
+        return token().is_cancelled();
+    }
+};
+
+template <typename T = void>
+class Task;
+
+namespace coroutine_detail
+{
+    struct PromiseBase
+    {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            // Resumes the awaiting coroutine directly (symmetric transfer, no stack growth).
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept
+            {
+                std::coroutine_handle<> continuation = finished.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept
+            {
+            }
+        };
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+        }
+    };
+
+    template <typename T>
+    struct Promise : PromiseBase
+    {
+        std::optional<T> value;
+
+        Task<T> get_return_object() noexcept;
+
+        template <typename U>
+        void return_value(U &&new_value)
+        {
+            value.emplace(std::forward<U>(new_value));
+        }
+
+        T result()
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+            return std::move(*value);
+        }
+    };
+
+    template <>
+    struct Promise<void> : PromiseBase
+    {
+        Task<void> get_return_object() noexcept;
+
+        void return_void() noexcept
+        {
+        }
+
+        void result()
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+    };
+}
+
+template <typename T>
+class Task
+{
+public:
+    typedef coroutine_detail::Promise<T> promise_type;
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    struct Awaiter
+    {
+        std::coroutine_handle<promise_type> handle;
+
+        bool await_ready() const noexcept
+        {
+            return !handle || handle.done();
+        }
+
+        // Starts the task; it resumes the awaiting coroutine when it finishes.
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        // An empty (default-constructed or moved-from) Task has no result.
+        T await_resume()
+        {
+            if (!handle)
+            {
+                throw std::logic_error("co_await on an empty Task");
+            }
+            return handle.promise().result();
+        }
+    };
+
+public:
+    Task() = default;
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+            {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task()
+    {
+        if (handle)
+        {
+            handle.destroy();
+        }
+    }
+
+    Awaiter operator co_await() const & noexcept
+    {
+        return Awaiter{handle};
+    }
+
+    Awaiter operator co_await() const && noexcept
+    {
+        return Awaiter{handle};
+    }
+};
+
+namespace coroutine_detail
+{
+    template <typename T>
+    Task<T> Promise<T>::get_return_object() noexcept
+    {
+        return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> Promise<void>::get_return_object() noexcept
+    {
+        return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+    }
+
+    // A suspended sleep. Whoever fires it first (the deadline or a cancellation)
+    // resumes the coroutine; the other one finds it already fired and does nothing.
+    struct Timer
+    {
+        enum : int
+        {
+            ARMING,    // the sleeping coroutine is still suspending
+            ARMED,     // suspended, waiting for the deadline or a cancellation
+            EXPIRED,   // the deadline passed
+            CANCELLED, // cancelled before the deadline
+        };
+
+        std::coroutine_handle<> handle;
+        std::atomic<int> state{ARMING};
+
+        // Returns true if the caller has to resume the coroutine. While the
+        // coroutine is still suspending, it notices the result and does not suspend.
+        bool try_fire(int outcome)
+        {
+            int current = state.load(std::memory_order_acquire);
+            while (current == ARMING || current == ARMED)
+            {
+                if (state.compare_exchange_weak(current, outcome, std::memory_order_acq_rel))
+                {
+                    return current == ARMED;
+                }
+            }
+            return false;
+        }
+
+        bool has_fired() const
+        {
+            return state.load(std::memory_order_acquire) >= EXPIRED;
+        }
+    };
+
+    struct TimerEntry
+    {
+        std::chrono::steady_clock::time_point deadline;
+        std::shared_ptr<Timer> timer;
+
+        bool operator>(const TimerEntry &other) const
+        {
+            return deadline > other.deadline;
+        }
+    };
+
+    // Fire-and-forget coroutine used by Scheduler::spawn().
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_never initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            std::suspend_never final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void return_void() noexcept
+            {
+            }
+
+            // Like an exception escaping a std::thread.
+            void unhandled_exception() noexcept
+            {
+                std::terminate();
+            }
+        };
+    };
+}
+
+class SleepAwaiter;
+
+// Ready queue and timer heap shared by both schedulers. Any thread may post().
+class Scheduler
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    class ScheduleAwaiter
+    {
+    private:
+        Scheduler &scheduler;
+
+    public:
+        explicit ScheduleAwaiter(Scheduler &scheduler) : scheduler(scheduler) {}
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            scheduler.post(handle);
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+protected:
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable task_finished;
+    std::deque<std::coroutine_handle<>> ready;
+    std::priority_queue<coroutine_detail::TimerEntry, std::vector<coroutine_detail::TimerEntry>,
+                        std::greater<coroutine_detail::TimerEntry>>
+        timers;
+    size_t active = 0; // spawned tasks that have not finished
+
+    // Runs ready coroutines and due timers on the calling thread until stop()
+    // returns true. stop() is called with the mutex held.
+    template <typename Stop>
+    void work(Stop stop)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop())
+        {
+            Clock::time_point now = Clock::now();
+            while (!timers.empty() && (timers.top().timer->has_fired() || timers.top().deadline <= now))
+            {
+                std::shared_ptr<coroutine_detail::Timer> timer = timers.top().timer;
+                timers.pop();
+                if (timer->try_fire(coroutine_detail::Timer::EXPIRED))
+                {
+                    ready.push_back(timer->handle);
+                }
+            }
+            if (!ready.empty())
+            {
+                std::coroutine_handle<> handle = ready.front();
+                ready.pop_front();
+                lock.unlock();
+                handle.resume();
+                lock.lock();
+                continue;
+            }
+            if (timers.empty())
+            {
+                work_available.wait(lock);
+            }
+            else
+            {
+                // A copy: the heap can change while this thread waits.
+                Clock::time_point next_deadline = timers.top().deadline;
+                work_available.wait_until(lock, next_deadline);
+            }
+        }
+    }
+
+    // Blocks the calling thread until done() is true (called with the mutex held).
+    virtual void run_until(const std::function<bool()> &done) = 0;
+
+private:
+    static coroutine_detail::Detached run_detached(Scheduler &scheduler, Task<void> task)
+    {
+        co_await scheduler.schedule();
+        co_await task;
+        std::lock_guard<std::mutex> lock(scheduler.mutex);
+        --scheduler.active;
+        scheduler.task_finished.notify_all();
+    }
+
+    // Owns the promise: block_on() may return (as soon as the future is ready)
+    // while this coroutine is still inside set_value().
+    template <typename T>
+    static Task<void> deliver(Task<T> task, std::promise<T> result)
+    {
+        try
+        {
+            if constexpr (std::is_void<T>::value)
+            {
+                co_await task;
+                result.set_value();
+            }
+            else
+            {
+                result.set_value(co_await task);
+            }
+        }
+        catch (...)
+        {
+            result.set_exception(std::current_exception());
+        }
+    }
+
+public:
+    Scheduler() = default;
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+    virtual ~Scheduler() = default;
+
+    // Queues a suspended coroutine to be resumed.
+    void post(std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.push_back(handle);
+        }
+        work_available.notify_one();
+    }
+
+    void post_at(Clock::time_point deadline, std::shared_ptr<coroutine_detail::Timer> timer)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            timers.push(coroutine_detail::TimerEntry{deadline, std::move(timer)});
+        }
+        // The new timer may be due before the one the workers are waiting for.
+        work_available.notify_all();
+    }
+
+    // co_await scheduler.schedule() continues the coroutine on the scheduler.
+    ScheduleAwaiter schedule()
+    {
+        return ScheduleAwaiter(*this);
+    }
+
+    SleepAwaiter sleep_until(Clock::time_point deadline, CancellationToken token = CancellationToken());
+
+    template <typename Rep, typename Period>
+    SleepAwaiter sleep_for(std::chrono::duration<Rep, Period> duration, CancellationToken token = CancellationToken());
+
+    // Starts task on the scheduler without waiting for it. An exception escaping
+    // the task terminates the program, as it would from a std::thread.
+    void spawn(Task<void> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++active;
+        }
+        run_detached(*this, std::move(task));
+    }
+
+    // Runs task to completion and returns its result (or rethrows its exception).
+    template <typename T>
+    T block_on(Task<T> task)
+    {
+        std::promise<T> result;
+        std::future<T> future = result.get_future();
+        spawn(deliver(std::move(task), std::move(result)));
+        run_until([&future]()
+                  { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+        return future.get();
+    }
+};
+
+// co_await scheduler.sleep_for(duration[, token]): suspends without blocking a thread.
+class SleepAwaiter
+{
+private:
+    Scheduler &scheduler;
+    Scheduler::Clock::time_point deadline;
+    CancellationToken token;
+    std::shared_ptr<coroutine_detail::Timer> timer;
+    size_t registration = 0;
+
+public:
+    SleepAwaiter(Scheduler &scheduler, Scheduler::Clock::time_point deadline, CancellationToken token)
+        : scheduler(scheduler), deadline(deadline), token(std::move(token))
+    {
+    }
+
+    bool await_ready() const
+    {
+        return token.is_cancelled();
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        timer = std::make_shared<coroutine_detail::Timer>();
+        timer->handle = handle;
+        scheduler.post_at(deadline, timer);
+        if (token.state)
+        {
+            std::shared_ptr<coroutine_detail::Timer> cancelled_timer = timer;
+            Scheduler *target = &scheduler;
+            registration = token.state->add([cancelled_timer, target]()
+                                            {
+                                                if (cancelled_timer->try_fire(coroutine_detail::Timer::CANCELLED))
+                                                {
+                                                    target->post(cancelled_timer->handle);
+                                                } });
+        }
+        // From here on the timer may fire on another thread; this awaiter is not
+        // touched again until the coroutine resumes.
+        int expected = coroutine_detail::Timer::ARMING;
+        return timer->state.compare_exchange_strong(expected, coroutine_detail::Timer::ARMED, std::memory_order_acq_rel);
+    }
+
+    void await_resume()
+    {
+        if (registration != 0)
+        {
+            token.state->remove(registration);
+        }
+        if (!timer || timer->state.load(std::memory_order_acquire) == coroutine_detail::Timer::CANCELLED)
+        {
+            throw OperationCancelled();
+        }
+    }
+};
+
+inline SleepAwaiter Scheduler::sleep_until(Clock::time_point deadline, CancellationToken token)
+{
+    return SleepAwaiter(*this, deadline, std::move(token));
+}
+
+template <typename Rep, typename Period>
+SleepAwaiter Scheduler::sleep_for(std::chrono::duration<Rep, Period> duration, CancellationToken token)
+{
+    return sleep_until(Clock::now() + duration, std::move(token));
+}
+
+// Runs everything on the thread that calls run() or block_on().
+class SingleThreadScheduler : public Scheduler
+{
+protected:
+    void run_until(const std::function<bool()> &done) override
+    {
+        work(done);
+    }
+
+public:
+    // Runs until every spawned task has finished.
+    void run()
+    {
+        work([this]()
+             { return active == 0; });
+    }
+};
+
+// Runs coroutines on a fixed number of worker threads. The destructor waits for
+// the spawned tasks to finish.
+class MultiThreadScheduler : public Scheduler
+{
+private:
+    std::vector<std::thread> threads;
+    bool stopping = false;
+
+protected:
+    void run_until(const std::function<bool()> &done) override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        task_finished.wait(lock, done);
+    }
+
+public:
+    explicit MultiThreadScheduler(size_t thread_count = std::thread::hardware_concurrency())
+    {
+        if (thread_count == 0)
+        {
+            thread_count = 1;
+        }
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back([this]()
+                                 { work([this]()
+                                        { return stopping; }); });
+        }
+    }
+
+    ~MultiThreadScheduler()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            task_finished.wait(lock, [this]()
+                               { return active == 0; });
+            stopping = true;
+        }
+        work_available.notify_all();
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Waits until every spawned task has finished.
+    void wait_idle()
+    {
+        run_until([this]()
+                  { return active == 0; });
+    }
+};
@@ -0,0 +1,99 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sharded_counter.h"
+
+// How the counters from atomic1.cpp, lock_guard1.cpp and mutex1.cpp scale with the
+// number of threads, compared with ShardedCounter. Every thread does the same
+// number of increments; the table shows total increments per second.
+//
+// Usage: counter_bench [increments per thread] [max threads]
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Increment>
+double run(int threads, long increments, Increment increment)
+{
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]()
+                             {
+                                 while (!go.load(std::memory_order_acquire))
+                                 {
+                                     std::this_thread::yield();
+                                 }
+                                 for (long i = 0; i < increments; ++i)
+                                 {
+                                     increment();
+                                 } });
+    }
+    Clock::time_point start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return threads * increments / seconds / 1e6;
+}
+
+static void check(const char *name, long long value, long long expected)
+{
+    if (value != expected)
+    {
+        std::fprintf(stderr, "%s: counted %lld, expected %lld\n", name, value, expected);
+        std::exit(1);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    long increments = argc > 1 ? std::atol(argv[1]) : 1000000;
+    int max_threads = argc > 2 ? std::atoi(argv[2]) : 64;
+
+    std::printf("%ld increments per thread, %u hardware threads, M increments/s\n",
+                increments, std::thread::hardware_concurrency());
+    std::printf("%8s %12s %12s %12s %12s\n", "threads", "atomic", "lock_guard", "mutex", "sharded");
+
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        long long expected = static_cast<long long>(threads) * increments;
+
+        std::atomic<long long> atomic_variable(0);
+        double atomic_rate = run(threads, increments, [&]()
+                                 { ++atomic_variable; });
+        check("atomic", atomic_variable.load(), expected);
+
+        std::mutex mtx;
+        long long guarded_variable = 0;
+        double lock_guard_rate = run(threads, increments, [&]()
+                                     {
+                                         std::lock_guard<std::mutex> lock(mtx);
+                                         ++guarded_variable; });
+        check("lock_guard", guarded_variable, expected);
+
+        long long locked_variable = 0;
+        double mutex_rate = run(threads, increments, [&]()
+                                {
+                                    mtx.lock();
+                                    ++locked_variable;
+                                    mtx.unlock(); });
+        check("mutex", locked_variable, expected);
+
+        // One shard per thread, so no two threads ever share a cache line.
+        ShardedCounter sharded(threads);
+        double sharded_rate = run(threads, increments, [&]()
+                                  { ++sharded; });
+        check("sharded", sharded.load(), expected);
+
+        std::printf("%8d %12.1f %12.1f %12.1f %12.1f\n", threads, atomic_rate, lock_guard_rate, mutex_rate, sharded_rate);
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "continuation_future.h"
+#include "thread_pool.h"
+
+int calculate_sum(int a, int b)
+{
+    int sum = a + b;
+    if (sum % 2 != 0)
+    {
+        throw std::runtime_error("Sum is odd");
+    }
+    return sum;
+}
+
+int main()
+{
+    ThreadPool pool(4);
+
+    // A pipeline: each step starts on the pool when the previous one completes. The
+    // second step starts another task and returns its future, which then() unwraps.
+    Future<std::string> report = run_on(pool, calculate_sum, 10, 20)
+                                     .then(pool, [&pool](int sum)
+                                           { return run_on(pool, [](int value)
+                                                           { return value * 2; },
+                                                           sum); })
+                                     .then(pool, [](int doubled)
+                                           { return "Result: " + std::to_string(doubled); });
+
+    // Fan-in: several sums at once.
+    std::vector<Future<int>> sums;
+    for (int i = 0; i < 5; ++i)
+    {
+        sums.push_back(run_on(pool, calculate_sum, i, i));
+    }
+    Future<int> total = when_all(std::move(sums)).then([](const std::vector<int> &values)
+                                                      {
+                                                          int sum = 0;
+                                                          for (int value : values)
+                                                          {
+                                                              sum += value;
+                                                          }
+                                                          return sum; });
+
+    // Fan-in of different types.
+    Future<std::tuple<int, std::string>> pair = when_all(run_on(pool, calculate_sum, 2, 2), make_ready_future(std::string("cars")));
+
+    // First of two results.
+    std::vector<Future<int>> race;
+    race.push_back(run_on(pool, calculate_sum, 1, 1));
+    race.push_back(run_on(pool, calculate_sum, 2, 2));
+    Future<std::pair<size_t, int>> first = when_any(std::move(race));
+
+    // An odd sum fails; the exception skips the value step and reaches the
+    // continuation that takes the future.
+    Future<std::string> odd = run_on(pool, calculate_sum, 3, 4)
+                                  .then([](int sum)
+                                        { return sum * 2; })
+                                  .then([](Future<int> result)
+                                        {
+                                            try
+                                            {
+                                                return "Result: " + std::to_string(result.get());
+                                            }
+                                            catch (const std::exception &e)
+                                            {
+                                                return std::string("Exception caught: ") + e.what();
+                                            } });
+
+    // Only main() blocks, once, at the end.
+    std::cout << report.get() << std::endl;
+    std::cout << "Total: " << total.get() << std::endl;
+    std::cout << "First: future " << first.get().first << " = " << first.get().second << std::endl;
+    std::cout << std::get<0>(pair.get()) << " " << std::get<1>(pair.get()) << std::endl;
+    std::cout << odd.get() << std::endl;
+
+    try
+    {
+        run_on(pool, calculate_sum, 5, 6).get();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Exception caught: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "locks.h"
+#include "lock_profiler.h"
+
+// Threads increment a shared variable under a lock_guard, as in
+// lock_guard1.cpp, once per lock type. Then readers and a writer share a
+// RwLock and a std::shared_mutex, and finally a profiled run prints the
+// contention report.
+//
+// Usage: lock_bench [increments per thread] [max threads=8]
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Lock>
+void increment(const char *name, int threads, long increments)
+{
+    Lock mtx;
+    long shared_variable = 0;
+    std::vector<std::thread> workers;
+
+    Clock::time_point start = Clock::now();
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&]()
+                             {
+                                 for (long i = 0; i < increments; ++i)
+                                 {
+                                     std::lock_guard<Lock> lock(mtx);
+                                     ++shared_variable;
+                                 } });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (shared_variable != threads * increments)
+    {
+        std::fprintf(stderr, "%s: expected %ld, got %ld\n", name, threads * increments, shared_variable);
+        std::exit(1);
+    }
+    std::printf("%-14s %2d threads %8.2f M locks/s\n", name, threads, threads * increments / seconds / 1e6);
+}
+
+// One writer and (threads - 1) readers; readers take the lock 100 times as often.
+template <typename Lock>
+void read_mostly(const char *name, int threads, long increments)
+{
+    Lock mtx;
+    long value = 0;
+    std::vector<std::thread> workers;
+
+    Clock::time_point start = Clock::now();
+    workers.emplace_back([&]()
+                         {
+                             for (long i = 0; i < increments / 100; ++i)
+                             {
+                                 std::lock_guard<Lock> lock(mtx);
+                                 ++value;
+                             } });
+    for (int t = 1; t < threads; ++t)
+    {
+        workers.emplace_back([&]()
+                             {
+                                 long seen = 0;
+                                 for (long i = 0; i < increments; ++i)
+                                 {
+                                     std::shared_lock<Lock> lock(mtx);
+                                     seen += value;
+                                 }
+                                 if (seen < 0)
+                                 {
+                                     std::printf("impossible\n");
+                                 } });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::printf("%-14s %2d threads %8.2f M reads/s\n", name, threads, (threads - 1) * increments / seconds / 1e6);
+}
+
+lock_profiler::Site queue_site("queue_mtx");
+ProfiledLock<std::mutex> queue_mtx(queue_site);
+std::mutex stats_mtx;
+long queued = 0;
+long total = 0;
+
+void profiled_worker(long increments)
+{
+    for (long i = 0; i < increments; ++i)
+    {
+        {
+            std::lock_guard<ProfiledLock<std::mutex>> lock(queue_mtx);
+            ++queued;
+        }
+        if (i % 10 == 0)
+        {
+            PROFILED_LOCK_GUARD(lock, stats_mtx);
+            ++total;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    long increments = argc > 1 ? std::atol(argv[1]) : 1000000;
+    int max_threads = argc > 2 ? std::atoi(argv[2]) : 8;
+
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        increment<std::mutex>("std::mutex", threads, increments);
+        increment<AdaptiveMutex>("AdaptiveMutex", threads, increments);
+        // A FIFO spin lock collapses once waiters outnumber cores: the next
+        // ticket holder is often not running when the lock is handed over.
+        if (threads <= static_cast<int>(std::thread::hardware_concurrency()))
+        {
+            increment<TicketLock>("TicketLock", threads, increments);
+        }
+        else
+        {
+            std::printf("%-14s %2d threads  skipped (more threads than cores)\n", "TicketLock", threads);
+        }
+        increment<RwLock>("RwLock", threads, increments);
+    }
+
+    for (int threads = 2; threads <= max_threads; threads *= 2)
+    {
+        read_mostly<std::shared_mutex>("shared_mutex", threads, increments);
+        read_mostly<RwLock>("RwLock", threads, increments);
+    }
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back(profiled_worker, increments / 4);
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    std::printf("\nContention (LOCK_PROFILING=%d):\n", LOCK_PROFILING);
+    lock_profiler::report();
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <type_traits>
+
+// Contention profiling for any lock with lock()/try_lock()/unlock().
+//
+// Per call site:
+//     PROFILED_LOCK_GUARD(lock, mtx);   // instead of std::lock_guard<std::mutex> lock(mtx);
+//
+// Per lock (drop-in for the lock type, still usable with std::lock_guard):
+//     lock_profiler::Site mtx_site("mtx");
+//     ProfiledLock<std::mutex> mtx(mtx_site);
+//
+// Each site counts acquisitions, how many of them had to wait, the total wait
+// time and a histogram of wait times in power-of-two nanosecond buckets.
+// lock_profiler::report() prints every site. An uncontended acquisition costs
+// one try_lock() and one relaxed increment.
+//
+// Build with -DLOCK_PROFILING=0 and PROFILED_LOCK_GUARD becomes a plain
+// std::lock_guard.
+#ifndef LOCK_PROFILING
+#define LOCK_PROFILING 1
+#endif
+
+namespace lock_profiler
+{
+    const int BUCKETS = 40; // bucket i: waits in [2^i, 2^(i+1)) ns
+
+    class Site
+    {
+    private:
+        static std::atomic<Site *> &first()
+        {
+            static std::atomic<Site *> head{nullptr};
+            return head;
+        }
+
+        Site *next = nullptr;
+
+    public:
+        const char *name;
+        const char *file;
+        int line;
+        std::atomic<uint64_t> acquisitions{0};
+        std::atomic<uint64_t> contended{0};
+        std::atomic<uint64_t> wait_ns{0};
+        std::atomic<uint64_t> histogram[BUCKETS] = {};
+
+        // Sites live for the whole program (function-local statics or globals).
+        Site(const char *name, const char *file = "", int line = 0) : name(name), file(file), line(line)
+        {
+            next = first().load(std::memory_order_relaxed);
+            while (!first().compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        Site(const Site &) = delete;
+        Site &operator=(const Site &) = delete;
+
+        void record_wait(uint64_t ns)
+        {
+            contended.fetch_add(1, std::memory_order_relaxed);
+            wait_ns.fetch_add(ns, std::memory_order_relaxed);
+            int bucket = 0;
+            while (bucket < BUCKETS - 1 && (ns >> (bucket + 1)) != 0)
+            {
+                ++bucket;
+            }
+            histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Upper bound of the bucket that holds the given fraction of the waits.
+        uint64_t wait_percentile(double fraction) const
+        {
+            uint64_t total = contended.load(std::memory_order_relaxed);
+            uint64_t target = static_cast<uint64_t>(total * fraction);
+            uint64_t seen = 0;
+            for (int bucket = 0; bucket < BUCKETS; ++bucket)
+            {
+                seen += histogram[bucket].load(std::memory_order_relaxed);
+                if (seen > target)
+                {
+                    return uint64_t(2) << bucket;
+                }
+            }
+            return 0;
+        }
+
+        void print(std::FILE *out) const
+        {
+            uint64_t total = acquisitions.load(std::memory_order_relaxed);
+            uint64_t waited = contended.load(std::memory_order_relaxed);
+            std::fprintf(out, "%-24s %s:%d\n", name, file, line);
+            std::fprintf(out, "    %llu acquisitions, %llu contended (%.1f%%), total wait %.3f ms",
+                         static_cast<unsigned long long>(total), static_cast<unsigned long long>(waited),
+                         total == 0 ? 0.0 : 100.0 * waited / total, wait_ns.load(std::memory_order_relaxed) / 1e6);
+            if (waited > 0)
+            {
+                std::fprintf(out, ", wait p50 < %llu ns, p99 < %llu ns",
+                             static_cast<unsigned long long>(wait_percentile(0.5)),
+                             static_cast<unsigned long long>(wait_percentile(0.99)));
+            }
+            std::fprintf(out, "\n");
+            for (int bucket = 0; bucket < BUCKETS; ++bucket)
+            {
+                uint64_t count = histogram[bucket].load(std::memory_order_relaxed);
+                if (count != 0)
+                {
+                    std::fprintf(out, "    < %12llu ns: %llu\n", static_cast<unsigned long long>(uint64_t(2) << bucket),
+                                 static_cast<unsigned long long>(count));
+                }
+            }
+        }
+
+        static void report(std::FILE *out = stdout)
+        {
+            for (Site *site = first().load(std::memory_order_acquire); site != nullptr; site = site->next)
+            {
+                site->print(out);
+            }
+        }
+    };
+
+    inline void report(std::FILE *out = stdout)
+    {
+        Site::report(out);
+    }
+
+    template <typename Lock>
+    void lock(Lock &lock, Site &site)
+    {
+        site.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if (lock.try_lock())
+        {
+            return;
+        }
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        lock.lock();
+        site.record_wait(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+    }
+}
+
+// std::lock_guard that records contention against a call site.
+template <typename Lock>
+class ProfiledLockGuard
+{
+private:
+    Lock &lock;
+
+public:
+    ProfiledLockGuard(Lock &lock, lock_profiler::Site &site) : lock(lock)
+    {
+        lock_profiler::lock(lock, site);
+    }
+
+    ProfiledLockGuard(const ProfiledLockGuard &) = delete;
+    ProfiledLockGuard &operator=(const ProfiledLockGuard &) = delete;
+
+    ~ProfiledLockGuard()
+    {
+        lock.unlock();
+    }
+};
+
+// A lock that records all of its contention against one site.
+template <typename Lock>
+class ProfiledLock
+{
+private:
+    Lock inner;
+    lock_profiler::Site &site;
+
+public:
+    explicit ProfiledLock(lock_profiler::Site &site) : site(site) {}
+
+    void lock()
+    {
+        lock_profiler::lock(inner, site);
+    }
+
+    bool try_lock()
+    {
+        if (!inner.try_lock())
+        {
+            return false;
+        }
+        site.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void unlock()
+    {
+        inner.unlock();
+    }
+};
+
+#if LOCK_PROFILING
+#define PROFILED_LOCK_GUARD(guard, lock)                                \
+    static lock_profiler::Site guard##_site(#lock, __FILE__, __LINE__); \
+    ProfiledLockGuard<typename std::remove_reference<decltype(lock)>::type> guard(lock, guard##_site)
+#else
+#define PROFILED_LOCK_GUARD(guard, lock) \
+    std::lock_guard<typename std::remove_reference<decltype(lock)>::type> guard(lock)
+#endif
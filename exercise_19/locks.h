@@ -0,0 +1,211 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "backoff.h"
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Alternatives to std::mutex. All of them have lock()/try_lock()/unlock(), so
+// they work with std::lock_guard and std::unique_lock; RwLock also has the
+// *_shared() members for std::shared_lock.
+//
+//   AdaptiveMutex - spins briefly (most critical sections are short), then parks
+//                   the thread in the kernel instead of burning CPU
+//   TicketLock    - FIFO spin lock: threads get the lock in arrival order
+//   RwLock        - many readers or one writer; readers never wait for a writer
+//                   that is only waiting (reader-biased: writers can starve)
+
+namespace lock_detail
+{
+    // Sleeps while word == expected (or until woken); may wake spuriously.
+    inline void park(std::atomic<int> &word, int expected)
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<int *>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+        (void)word;
+        (void)expected;
+        std::this_thread::yield();
+#endif
+    }
+
+    inline void unpark_one(std::atomic<int> &word)
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<int *>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        (void)word;
+#endif
+    }
+}
+
+class AdaptiveMutex
+{
+private:
+    enum : int
+    {
+        UNLOCKED,
+        LOCKED,
+        LOCKED_WITH_WAITERS // someone may be parked; unlock() has to wake one
+    };
+
+    static constexpr int SPIN_ROUNDS = 10; // Backoff rounds before parking
+
+    std::atomic<int> state{UNLOCKED};
+
+public:
+    AdaptiveMutex() = default;
+    AdaptiveMutex(const AdaptiveMutex &) = delete;
+    AdaptiveMutex &operator=(const AdaptiveMutex &) = delete;
+
+    bool try_lock()
+    {
+        int expected = UNLOCKED;
+        return state.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void lock()
+    {
+        Backoff backoff;
+        for (int round = 0; round < SPIN_ROUNDS; ++round)
+        {
+            // Test before test-and-set: spin on a shared read, not on a CAS.
+            if (state.load(std::memory_order_relaxed) == UNLOCKED && try_lock())
+            {
+                return;
+            }
+            backoff.pause();
+        }
+        // Announce a waiter; whoever holds the lock will wake us on unlock().
+        while (state.exchange(LOCKED_WITH_WAITERS, std::memory_order_acquire) != UNLOCKED)
+        {
+            lock_detail::park(state, LOCKED_WITH_WAITERS);
+        }
+    }
+
+    void unlock()
+    {
+        if (state.exchange(UNLOCKED, std::memory_order_release) == LOCKED_WITH_WAITERS)
+        {
+            lock_detail::unpark_one(state);
+        }
+    }
+};
+
+class TicketLock
+{
+private:
+    static constexpr int SPIN_ROUNDS = 64;
+
+    alignas(64) std::atomic<uint32_t> next_ticket{0};
+    alignas(64) std::atomic<uint32_t> now_serving{0};
+
+public:
+    TicketLock() = default;
+    TicketLock(const TicketLock &) = delete;
+    TicketLock &operator=(const TicketLock &) = delete;
+
+    void lock()
+    {
+        uint32_t ticket = next_ticket.fetch_add(1, std::memory_order_relaxed);
+        for (int round = 0;; ++round)
+        {
+            uint32_t serving = now_serving.load(std::memory_order_acquire);
+            if (serving == ticket)
+            {
+                return;
+            }
+            // Wait roughly in proportion to the number of threads ahead of us.
+            for (uint32_t i = 0; i < (ticket - serving) * 32; ++i)
+            {
+                cpu_relax();
+            }
+            // A long queue, or a holder that is not running: let it have the CPU.
+            if (ticket - serving > 4 || round >= SPIN_ROUNDS)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool try_lock()
+    {
+        uint32_t serving = now_serving.load(std::memory_order_relaxed);
+        uint32_t expected = serving;
+        return next_ticket.compare_exchange_strong(expected, serving + 1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock()
+    {
+        now_serving.store(now_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+class RwLock
+{
+private:
+    // Bit 0: a writer holds the lock. Bits 1 and up: number of readers.
+    static constexpr uint32_t WRITER = 1;
+    static constexpr uint32_t READER = 2;
+
+    std::atomic<uint32_t> state{0};
+
+public:
+    RwLock() = default;
+    RwLock(const RwLock &) = delete;
+    RwLock &operator=(const RwLock &) = delete;
+
+    bool try_lock()
+    {
+        uint32_t expected = 0;
+        return state.compare_exchange_strong(expected, WRITER, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    // Waits until there are no readers and no writer.
+    void lock()
+    {
+        Backoff backoff;
+        while (!(state.load(std::memory_order_relaxed) == 0 && try_lock()))
+        {
+            backoff.pause();
+        }
+    }
+
+    void unlock()
+    {
+        state.fetch_and(~WRITER, std::memory_order_release);
+    }
+
+    bool try_lock_shared()
+    {
+        uint32_t current = state.load(std::memory_order_relaxed);
+        while ((current & WRITER) == 0)
+        {
+            if (state.compare_exchange_weak(current, current + READER, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Only waits while a writer actually holds the lock.
+    void lock_shared()
+    {
+        Backoff backoff;
+        while (!try_lock_shared())
+        {
+            backoff.pause();
+        }
+    }
+
+    void unlock_shared()
+    {
+        state.fetch_sub(READER, std::memory_order_release);
+    }
+};
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "backoff.h"
+
+// Bounded lock-free queues for handing work between threads.
+//
+// MpmcQueue<T> (any number of producers and consumers) is Dmitry Vyukov's ring
+// buffer: every cell carries a sequence number that says whether it is free for
+// the producer of a given lap or full for the consumer of that lap, so producers
+// and consumers only contend on the position counter they share with their own
+// kind. SpscQueue<T> is the cheaper single-producer single-consumer version.
+//
+// try_push()/try_pop() never wait; push()/pop() retry with exponential backoff
+// until there is room or an element. Capacities must be powers of two.
+
+inline size_t checked_queue_capacity(size_t capacity)
+{
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+    {
+        throw std::invalid_argument("queue capacity must be a power of two");
+    }
+    return capacity;
+}
+
+template <typename T>
+class MpmcQueue
+{
+private:
+    // One cell per cache line, so neighbouring producers/consumers don't false-share.
+    struct alignas(64) Cell
+    {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T *value()
+        {
+            return std::launder(reinterpret_cast<T *>(storage));
+        }
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueue_position{0};
+    alignas(64) std::atomic<size_t> dequeue_position{0};
+
+    // Claims the cell for the next push, or returns nullptr if the queue is full.
+    Cell *claim_for_push()
+    {
+        size_t position = enqueue_position.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (sequence == position)
+            {
+                if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    return &cell;
+                }
+            }
+            else if (sequence < position)
+            {
+                return nullptr;
+            }
+            else
+            {
+                position = enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Cell *claim_for_pop(size_t &position)
+    {
+        position = dequeue_position.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (sequence == position + 1)
+            {
+                if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    return &cell;
+                }
+            }
+            else if (sequence < position + 1)
+            {
+                return nullptr;
+            }
+            else
+            {
+                position = dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+public:
+    explicit MpmcQueue(size_t capacity) : cells(new Cell[checked_queue_capacity(capacity)]), mask(capacity - 1)
+    {
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue &) = delete;
+    MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+    ~MpmcQueue()
+    {
+        T value;
+        while (try_pop(value))
+        {
+        }
+    }
+
+    template <typename U>
+    bool try_push(U &&value)
+    {
+        Cell *cell = claim_for_push();
+        if (cell == nullptr)
+        {
+            return false;
+        }
+        size_t position = cell->sequence.load(std::memory_order_relaxed);
+        new (cell->storage) T(std::forward<U>(value));
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T &value)
+    {
+        size_t position;
+        Cell *cell = claim_for_pop(position);
+        if (cell == nullptr)
+        {
+            return false;
+        }
+        value = std::move(*cell->value());
+        cell->value()->~T();
+        cell->sequence.store(position + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename U>
+    void push(U &&value)
+    {
+        Backoff backoff;
+        while (!try_push(std::forward<U>(value)))
+        {
+            backoff.pause();
+        }
+    }
+
+    void pop(T &value)
+    {
+        Backoff backoff;
+        while (!try_pop(value))
+        {
+            backoff.pause();
+        }
+    }
+
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+};
+
+// One producer thread and one consumer thread. Each side keeps a cached copy of
+// the other side's position and only re-reads the shared one when the cache says
+// the queue is full (or empty), so most operations touch no shared cache line
+// except the element itself.
+template <typename T>
+class SpscQueue
+{
+private:
+    std::unique_ptr<unsigned char[]> raw;
+    T *slots;
+    size_t mask;
+
+    alignas(64) std::atomic<size_t> tail{0}; // written by the producer
+    size_t cached_head = 0;
+    alignas(64) std::atomic<size_t> head{0}; // written by the consumer
+    size_t cached_tail = 0;
+
+public:
+    explicit SpscQueue(size_t capacity)
+        : raw(new unsigned char[checked_queue_capacity(capacity) * sizeof(T) + alignof(T)]), mask(capacity - 1)
+    {
+        void *memory = raw.get();
+        size_t space = capacity * sizeof(T) + alignof(T);
+        slots = static_cast<T *>(std::align(alignof(T), capacity * sizeof(T), memory, space));
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    ~SpscQueue()
+    {
+        T value;
+        while (try_pop(value))
+        {
+        }
+    }
+
+    // Producer thread only.
+    template <typename U>
+    bool try_push(U &&value)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cached_head > mask)
+        {
+            cached_head = head.load(std::memory_order_acquire);
+            if (position - cached_head > mask)
+            {
+                return false;
+            }
+        }
+        new (&slots[position & mask]) T(std::forward<U>(value));
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only.
+    bool try_pop(T &value)
+    {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == cached_tail)
+        {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (position == cached_tail)
+            {
+                return false;
+            }
+        }
+        T *slot = std::launder(&slots[position & mask]);
+        value = std::move(*slot);
+        slot->~T();
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename U>
+    void push(U &&value)
+    {
+        Backoff backoff;
+        while (!try_push(std::forward<U>(value)))
+        {
+            backoff.pause();
+        }
+    }
+
+    void pop(T &value)
+    {
+        Backoff backoff;
+        while (!try_pop(value))
+        {
+            backoff.pause();
+        }
+    }
+
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+};
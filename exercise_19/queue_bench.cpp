@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "mpmc_queue.h"
+
+// Producer/consumer throughput and latency: MpmcQueue and SpscQueue against a
+// bounded std::queue guarded by a std::mutex and std::lock_guard (as in
+// lock_guard1.cpp). Every item carries the time it was pushed; consumers record
+// how long it waited in the queue.
+//
+// Usage: queue_bench [items per producer]
+
+typedef std::chrono::steady_clock Clock;
+
+const size_t CAPACITY = 1024;
+
+struct Item
+{
+    int64_t pushed_at; // nanoseconds since the clock's epoch, -1 marks the end
+};
+
+static int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// The baseline: bounded std::queue behind a mutex, same try/blocking interface.
+template <typename T>
+class MutexQueue
+{
+private:
+    std::mutex mtx;
+    std::queue<T> items;
+    size_t capacity;
+
+public:
+    explicit MutexQueue(size_t capacity) : capacity(capacity) {}
+
+    bool try_push(const T &value)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (items.size() >= capacity)
+        {
+            return false;
+        }
+        items.push(value);
+        return true;
+    }
+
+    bool try_pop(T &value)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (items.empty())
+        {
+            return false;
+        }
+        value = items.front();
+        items.pop();
+        return true;
+    }
+
+    void push(const T &value)
+    {
+        Backoff backoff;
+        while (!try_push(value))
+        {
+            backoff.pause();
+        }
+    }
+
+    void pop(T &value)
+    {
+        Backoff backoff;
+        while (!try_pop(value))
+        {
+            backoff.pause();
+        }
+    }
+};
+
+template <typename Queue>
+void run(const char *name, int producers, int consumers, long items_per_producer)
+{
+    Queue queue(CAPACITY);
+    std::vector<std::vector<int64_t>> latencies(consumers);
+    std::vector<std::thread> threads;
+
+    Clock::time_point start = Clock::now();
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&]()
+                             {
+                                 for (long i = 0; i < items_per_producer; ++i)
+                                 {
+                                     queue.push(Item{now_ns()});
+                                 } });
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&, c]()
+                             {
+                                 std::vector<int64_t> &samples = latencies[c];
+                                 samples.reserve(items_per_producer * producers / consumers / 16 + 1);
+                                 Item item;
+                                 long received = 0;
+                                 while (true)
+                                 {
+                                     queue.pop(item);
+                                     if (item.pushed_at < 0)
+                                     {
+                                         break;
+                                     }
+                                     if (received++ % 16 == 0)
+                                     {
+                                         samples.push_back(now_ns() - item.pushed_at);
+                                     }
+                                 } });
+    }
+    for (int p = 0; p < producers; ++p)
+    {
+        threads[p].join();
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        queue.push(Item{-1});
+    }
+    for (size_t t = producers; t < threads.size(); ++t)
+    {
+        threads[t].join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<int64_t> all;
+    for (const std::vector<int64_t> &samples : latencies)
+    {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    int64_t p50 = all.empty() ? 0 : all[all.size() / 2];
+    int64_t p99 = all.empty() ? 0 : all[all.size() * 99 / 100];
+
+    std::printf("%-8s %dP/%dC %10.2f M items/s   latency p50 %8lld ns  p99 %8lld ns\n", name, producers, consumers,
+                producers * items_per_producer / seconds / 1e6, static_cast<long long>(p50), static_cast<long long>(p99));
+}
+
+int main(int argc, char *argv[])
+{
+    long items = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+    std::printf("%ld items per producer, capacity %zu\n", items, CAPACITY);
+    run<MutexQueue<Item>>("mutex", 1, 1, items);
+    run<MpmcQueue<Item>>("mpmc", 1, 1, items);
+    run<SpscQueue<Item>>("spsc", 1, 1, items);
+    for (int threads = 2; threads <= 8; threads *= 2)
+    {
+        run<MutexQueue<Item>>("mutex", threads, threads, items);
+        run<MpmcQueue<Item>>("mpmc", threads, threads, items);
+    }
+
+    return 0;
+}
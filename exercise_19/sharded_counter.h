@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+// Counter for many writers and occasional readers. Instead of one atomic that
+// every thread increments (and whose cache line bounces between cores), the
+// threads are spread round-robin over several shards, each padded to a cache
+// line. load() adds the shards up.
+//
+// Increments are relaxed: load() is exact once the writers are done (e.g. after
+// join), and while they run it returns some value between the counts before and
+// after the concurrent increments.
+class ShardedCounter
+{
+private:
+    struct alignas(64) Shard
+    {
+        std::atomic<long long> value{0};
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    size_t mask;
+
+    static size_t default_shard_count()
+    {
+        size_t count = 1;
+        while (count < std::thread::hardware_concurrency())
+        {
+            count *= 2;
+        }
+        return count;
+    }
+
+    // Threads get consecutive numbers on first use (process-wide, never reused),
+    // which spreads them round-robin over the shards. Live threads can still
+    // share a shard, e.g. when others have exited in between.
+    static size_t thread_number()
+    {
+        static std::atomic<size_t> next_thread{0};
+        thread_local size_t number = next_thread.fetch_add(1, std::memory_order_relaxed);
+        return number;
+    }
+
+public:
+    // shard_count is rounded up to a power of two; 0 means one per hardware thread.
+    explicit ShardedCounter(size_t shard_count = 0)
+    {
+        size_t count = 1;
+        while (count < (shard_count == 0 ? default_shard_count() : shard_count))
+        {
+            count *= 2;
+        }
+        shards.reset(new Shard[count]);
+        mask = count - 1;
+    }
+
+    ShardedCounter(const ShardedCounter &) = delete;
+    ShardedCounter &operator=(const ShardedCounter &) = delete;
+
+    void add(long long amount)
+    {
+        shards[thread_number() & mask].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    ShardedCounter &operator++()
+    {
+        add(1);
+        return *this;
+    }
+
+    long long load() const
+    {
+        long long sum = 0;
+        for (size_t i = 0; i <= mask; ++i)
+        {
+            sum += shards[i].value.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    size_t shard_count() const
+    {
+        return mask + 1;
+    }
+};
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Fixed set of worker threads that run submitted tasks.
+//
+// Every worker has its own deque. A task submitted from inside a task goes onto
+// the current worker's deque, and the worker runs its newest task first (good
+// cache locality). Tasks submitted from other threads go into a shared
+// injection queue. A worker with nothing to do takes from the injection queue,
+// then tries to steal half of another worker's deque (oldest tasks first), and
+// only sleeps when there is no work anywhere.
+//
+// submit() returns a std::future. A task that throws stores the exception in the
+// future (set_exception), and future.get() rethrows it, as in future2.cpp.
+// A task should not block on the future of a task it submitted itself: once
+// every worker is waiting, no worker is left to run the subtasks.
+class ThreadPool
+{
+private:
+    // Move-only type-erased task (std::function requires copyable callables).
+    class Task
+    {
+    private:
+        struct Base
+        {
+            virtual ~Base() = default;
+            virtual void run() = 0;
+        };
+
+        template <typename Function>
+        struct Model : Base
+        {
+            Function function;
+            explicit Model(Function &&function) : function(std::move(function)) {}
+            void run() override { function(); }
+        };
+
+        std::unique_ptr<Base> callable;
+
+    public:
+        Task() = default;
+
+        template <typename Function>
+        explicit Task(Function function) : callable(new Model<Function>(std::move(function)))
+        {
+        }
+
+        void operator()()
+        {
+            callable->run();
+        }
+    };
+
+    struct alignas(64) Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks; // the owner works at the back, thieves take from the front
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex injection_mutex;
+    std::deque<Task> injection_queue;
+
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> sleepers{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleep_mutex;
+    std::condition_variable wake_up;
+
+    // Identifies the pool and worker the current thread belongs to, if any.
+    static ThreadPool *&current_pool()
+    {
+        thread_local ThreadPool *pool = nullptr;
+        return pool;
+    }
+
+    static size_t &current_worker()
+    {
+        thread_local size_t index = 0;
+        return index;
+    }
+
+    void push(Task task)
+    {
+        // Counted before it is visible, so a worker never sees pending drop below zero.
+        pending.fetch_add(1);
+        if (current_pool() == this)
+        {
+            Worker &worker = *workers[current_worker()];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(std::move(task));
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(injection_mutex);
+            injection_queue.push_back(std::move(task));
+        }
+        if (sleepers.load() > 0)
+        {
+            // Taking the lock makes sure a worker that just found no work is
+            // already waiting, so the notification cannot be missed.
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            wake_up.notify_one();
+        }
+    }
+
+    bool pop_local(size_t index, Task &task)
+    {
+        Worker &worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty())
+        {
+            return false;
+        }
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        return true;
+    }
+
+    bool pop_injected(Task &task)
+    {
+        std::lock_guard<std::mutex> lock(injection_mutex);
+        if (injection_queue.empty())
+        {
+            return false;
+        }
+        task = std::move(injection_queue.front());
+        injection_queue.pop_front();
+        return true;
+    }
+
+    // Moves the older half of a victim's tasks to this worker; runs the first one.
+    bool steal(size_t index, Task &task)
+    {
+        for (size_t offset = 1; offset < workers.size(); ++offset)
+        {
+            Worker &victim = *workers[(index + offset) % workers.size()];
+            std::deque<Task> stolen;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                size_t count = (victim.tasks.size() + 1) / 2;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    stolen.push_back(std::move(victim.tasks.front()));
+                    victim.tasks.pop_front();
+                }
+            }
+            if (stolen.empty())
+            {
+                continue;
+            }
+            task = std::move(stolen.front());
+            stolen.pop_front();
+            if (!stolen.empty())
+            {
+                Worker &worker = *workers[index];
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                for (Task &extra : stolen)
+                {
+                    worker.tasks.push_back(std::move(extra));
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool find_task(size_t index, Task &task)
+    {
+        if (pop_local(index, task) || pop_injected(task) || steal(index, task))
+        {
+            pending.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    void work(size_t index)
+    {
+        current_pool() = this;
+        current_worker() = index;
+
+        Task task;
+        while (true)
+        {
+            if (find_task(index, task))
+            {
+                task();
+                task = Task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleepers.fetch_add(1);
+            wake_up.wait(lock, [this]()
+                         { return pending.load() > 0 || stopping.load(); });
+            sleepers.fetch_sub(1);
+            if (stopping.load() && pending.load() == 0)
+            {
+                return;
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency())
+    {
+        if (thread_count == 0)
+        {
+            thread_count = 1;
+        }
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            workers.emplace_back(new Worker);
+        }
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back(&ThreadPool::work, this, i);
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Runs the tasks that are still queued, then stops the workers.
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping.store(true);
+        }
+        wake_up.notify_all();
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    template <typename Function, typename... Args>
+    auto submit(Function &&function, Args &&...args) -> std::future<typename std::invoke_result<Function, Args...>::type>
+    {
+        typedef typename std::invoke_result<Function, Args...>::type Result;
+        std::packaged_task<Result()> task(
+            [function = std::forward<Function>(function), arguments = std::make_tuple(std::forward<Args>(args)...)]() mutable
+            { return std::apply(std::move(function), std::move(arguments)); });
+        std::future<Result> future = task.get_future();
+        push(Task(std::move(task)));
+        return future;
+    }
+
+    // Runs function on the pool without a future (for fire-and-forget subtasks).
+    template <typename Function>
+    void post(Function &&function)
+    {
+        push(Task(std::forward<Function>(function)));
+    }
+
+    size_t get_thread_count() const
+    {
+        return threads.size();
+    }
+};
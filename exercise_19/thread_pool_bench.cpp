@@ -0,0 +1,167 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "thread_pool.h"
+
+// Tasks per second for calculate_sum-style work (future2.cpp without the sleep):
+//   thread per task - a std::thread and std::promise per call, like future1.cpp
+//   pool submit     - ThreadPool::submit from the main thread, then future.get()
+//   pool fan-out    - tasks that split themselves into subtasks on the workers,
+//                     which keeps the per-worker deques and stealing busy
+//
+// Usage: thread_pool_bench [tasks] [threads]
+
+typedef std::chrono::steady_clock Clock;
+
+int calculate_sum(int a, int b)
+{
+    int sum = a + b;
+    if (sum % 2 != 0)
+    {
+        throw std::runtime_error("Sum is odd");
+    }
+    return sum;
+}
+
+void calculate_sum_promise(std::promise<int> &&promise, int a, int b)
+{
+    try
+    {
+        promise.set_value(calculate_sum(a, b));
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+static double rate(int tasks, Clock::time_point start)
+{
+    return tasks / std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double thread_per_task(int tasks)
+{
+    const int IN_FLIGHT = 256; // keeps the number of live threads bounded
+    long long total = 0;
+    Clock::time_point start = Clock::now();
+    for (int first = 0; first < tasks; first += IN_FLIGHT)
+    {
+        std::vector<std::thread> threads;
+        std::vector<std::future<int>> futures;
+        for (int i = first; i < tasks && i < first + IN_FLIGHT; ++i)
+        {
+            std::promise<int> promise;
+            futures.push_back(promise.get_future());
+            threads.emplace_back(calculate_sum_promise, std::move(promise), i, i);
+        }
+        for (std::future<int> &future : futures)
+        {
+            total += future.get();
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+    }
+    double result = rate(tasks, start);
+    std::printf("%-16s %12.0f tasks/s (sum %lld)\n", "thread per task", result, total);
+    return result;
+}
+
+static double pool_submit(ThreadPool &pool, int tasks)
+{
+    long long total = 0;
+    Clock::time_point start = Clock::now();
+    std::vector<std::future<int>> futures;
+    futures.reserve(tasks);
+    for (int i = 0; i < tasks; ++i)
+    {
+        futures.push_back(pool.submit(calculate_sum, i, i));
+    }
+    for (std::future<int> &future : futures)
+    {
+        total += future.get();
+    }
+    double result = rate(tasks, start);
+    std::printf("%-16s %12.0f tasks/s (sum %lld)\n", "pool submit", result, total);
+    return result;
+}
+
+// Splits [first, last) in half until one element is left, posting each half as a
+// new task. Every split and leaf is a task.
+static void split(ThreadPool &pool, int first, int last, std::atomic<long long> &total, std::atomic<int> &remaining)
+{
+    if (last - first <= 0)
+    {
+        return;
+    }
+    if (last - first == 1)
+    {
+        total.fetch_add(calculate_sum(first, first), std::memory_order_relaxed);
+        remaining.fetch_sub(1, std::memory_order_release); // last access to the shared state
+        return;
+    }
+    int middle = first + (last - first) / 2;
+    pool.post([&pool, first, middle, &total, &remaining]()
+              { split(pool, first, middle, total, remaining); });
+    pool.post([&pool, middle, last, &total, &remaining]()
+              { split(pool, middle, last, total, remaining); });
+}
+
+static double pool_fan_out(ThreadPool &pool, int leaves)
+{
+    std::atomic<long long> total{0};
+    std::atomic<int> remaining{leaves};
+
+    Clock::time_point start = Clock::now();
+    pool.post([&]()
+              { split(pool, 0, leaves, total, remaining); });
+    while (remaining.load(std::memory_order_acquire) > 0)
+    {
+        std::this_thread::yield();
+    }
+    int tasks = 2 * leaves - 1;
+    double result = rate(tasks, start);
+    std::printf("%-16s %12.0f tasks/s (sum %lld)\n", "pool fan-out", result, total.load());
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    int tasks = argc > 1 ? std::atoi(argv[1]) : 100000;
+    size_t threads = argc > 2 ? std::atoi(argv[2]) : std::thread::hardware_concurrency();
+    if (tasks < 1)
+    {
+        std::cerr << "Usage: " << argv[0] << " [tasks (at least 1)] [threads]" << std::endl;
+        return 1;
+    }
+
+    ThreadPool pool(threads);
+    std::printf("%d tasks, %zu pool threads\n", tasks, pool.get_thread_count());
+
+    // Exceptions reach the caller through the future, as with set_exception in future2.cpp.
+    std::future<int> odd = pool.submit(calculate_sum, 3, 4);
+    try
+    {
+        int result = odd.get();
+        std::cout << "Result: " << result << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Exception caught: " << e.what() << std::endl;
+    }
+
+    double baseline = thread_per_task(tasks);
+    double submitted = pool_submit(pool, tasks);
+    pool_fan_out(pool, tasks);
+    std::printf("pool submit is %.1fx thread per task\n", submitted / baseline);
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Monotonic arena. Allocation bumps a pointer inside the current block and
+// individual deallocation is a no-op; release() frees the whole batch at once.
+//
+// Objects made with create<T>() are destroyed by release() in reverse order of
+// creation. Only types with a non-trivial destructor are recorded, so releasing a
+// batch of trivially destructible objects is O(1) in the number of objects.
+//
+// Arena is a std::pmr::memory_resource, so pmr containers can allocate from it:
+//     Arena arena;
+//     std::pmr::vector<int> numbers(&arena);
+class Arena : public std::pmr::memory_resource
+{
+private:
+    struct Block
+    {
+        Block *previous;
+        size_t size;
+    };
+
+    struct Destructor
+    {
+        void (*destroy)(void *);
+        void *object;
+        Destructor *previous;
+    };
+
+    std::pmr::memory_resource *upstream;
+    size_t next_block_size;
+    Block *blocks = nullptr;
+    char *current = nullptr;
+    char *end = nullptr;
+    Destructor *destructors = nullptr;
+    size_t bytes_used = 0;
+
+    void add_block(size_t min_size)
+    {
+        size_t size = next_block_size;
+        while (size < min_size + sizeof(Block))
+        {
+            size *= 2;
+        }
+        Block *block = static_cast<Block *>(upstream->allocate(size, alignof(std::max_align_t)));
+        block->previous = blocks;
+        block->size = size;
+        blocks = block;
+        current = reinterpret_cast<char *>(block + 1);
+        end = reinterpret_cast<char *>(block) + size;
+        next_block_size = size * 2;
+    }
+
+    void run_destructors()
+    {
+        while (destructors != nullptr)
+        {
+            Destructor *destructor = destructors;
+            destructors = destructor->previous;
+            destructor->destroy(destructor->object);
+        }
+    }
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(current) % alignment) % alignment;
+        if (current == nullptr || bytes + padding > static_cast<size_t>(end - current))
+        {
+            add_block(bytes + alignment);
+            padding = (alignment - reinterpret_cast<uintptr_t>(current) % alignment) % alignment;
+        }
+        char *result = current + padding;
+        current = result + bytes;
+        bytes_used += bytes;
+        return result;
+    }
+
+    void do_deallocate(void *, size_t, size_t) override
+    {
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+
+public:
+    explicit Arena(size_t initial_block_size = 64 * 1024,
+                   std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+        : upstream(upstream), next_block_size(initial_block_size)
+    {
+    }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena()
+    {
+        release();
+        if (blocks != nullptr)
+        {
+            upstream->deallocate(blocks, blocks->size, alignof(std::max_align_t));
+        }
+    }
+
+    template <typename T, typename... Args>
+    T *create(Args &&...args)
+    {
+        void *memory = allocate(sizeof(T), alignof(T));
+        T *object = new (memory) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible<T>::value)
+        {
+            Destructor *destructor = static_cast<Destructor *>(allocate(sizeof(Destructor), alignof(Destructor)));
+            destructor->destroy = [](void *pointer)
+            { static_cast<T *>(pointer)->~T(); };
+            destructor->object = object;
+            destructor->previous = destructors;
+            destructors = destructor;
+        }
+        return object;
+    }
+
+    // Destroys every object made with create() and frees the batch. The newest
+    // (largest) block is kept, so the next batch of the same size needs no
+    // upstream allocation.
+    void release()
+    {
+        run_destructors();
+        if (blocks == nullptr)
+        {
+            return;
+        }
+        while (blocks->previous != nullptr)
+        {
+            Block *previous = blocks->previous;
+            blocks->previous = previous->previous;
+            upstream->deallocate(previous, previous->size, alignof(std::max_align_t));
+        }
+        current = reinterpret_cast<char *>(blocks + 1);
+        end = reinterpret_cast<char *>(blocks) + blocks->size;
+        bytes_used = 0;
+    }
+
+    size_t get_bytes_used() const
+    {
+        return bytes_used;
+    }
+};
@@ -0,0 +1,108 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <vector>
+#include "arena.h"
+#include "car.h"
+#include "../exercise_14/chunked_garage.h"
+#include "../exercise_14/truck.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// Trivially destructible record: the arena frees a batch of these without visiting them.
+struct PlateRecord
+{
+    char number_plate[20];
+    int id;
+};
+
+static double elapsed_ms(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const int batches = 3;
+
+    std::cout << batches << " batches of " << count << " cars" << std::endl;
+
+    double new_build_ms = 0;
+    double delete_ms = 0;
+    std::vector<Car *> cars(count);
+    for (int batch = 0; batch < batches; ++batch)
+    {
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < count; ++i)
+        {
+            cars[i] = new Car{"LH "};
+        }
+        new_build_ms += elapsed_ms(start);
+
+        start = Clock::now();
+        for (Car *car : cars)
+        {
+            delete car;
+        }
+        delete_ms += elapsed_ms(start);
+    }
+
+    double arena_build_ms = 0;
+    double release_ms = 0;
+    Arena arena;
+    for (int batch = 0; batch < batches; ++batch)
+    {
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < count; ++i)
+        {
+            cars[i] = arena.create<Car>("LH ");
+        }
+        arena_build_ms += elapsed_ms(start);
+
+        start = Clock::now();
+        arena.release();
+        release_ms += elapsed_ms(start);
+    }
+
+    double record_new_ms = 0;
+    double record_arena_ms = 0;
+    std::vector<PlateRecord *> records(count);
+    for (int batch = 0; batch < batches; ++batch)
+    {
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < count; ++i)
+        {
+            records[i] = new PlateRecord{"LH ", i};
+        }
+        for (PlateRecord *record : records)
+        {
+            delete record;
+        }
+        record_new_ms += elapsed_ms(start);
+
+        start = Clock::now();
+        for (int i = 0; i < count; ++i)
+        {
+            records[i] = arena.create<PlateRecord>(PlateRecord{"LH ", i});
+        }
+        arena.release();
+        record_arena_ms += elapsed_ms(start);
+    }
+
+    // Containers and garages can draw from the same arena.
+    std::pmr::vector<int> numbers(&arena);
+    numbers.assign(1000, 42);
+    ChunkedGarage<Truck> *garage = arena.create<ChunkedGarage<Truck>>(&arena);
+    garage->emplace_vehicle(1, "Volvo", "FH16", 3, 40000, 10);
+    size_t garage_bytes = arena.get_bytes_used();
+    arena.release();
+
+    std::cout << "new/delete: build " << new_build_ms << " ms, destroy " << delete_ms << " ms" << std::endl;
+    std::cout << "arena:      build " << arena_build_ms << " ms, release " << release_ms << " ms" << std::endl;
+    std::cout << "plain records, build + free: new/delete " << record_new_ms << " ms, arena " << record_arena_ms << " ms" << std::endl;
+    std::cout << "pmr vector + garage used " << garage_bytes << " arena bytes" << std::endl;
+
+    return 0;
+}
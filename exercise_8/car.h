@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <string.h>
+#include "../exercise_9/lifecycle_trace.h"
 
 class Car
 {
@@ -12,12 +13,12 @@ private:
 public:
     Car() : Car("")
     {
-        std::cout << "1 Car constructor called: " << std::endl;
+        lifecycle_trace::event("1 Car constructor called: ");
     }
 
     Car(const char *new_number_plate)
     {
-        std::cout << "2 Car constructor called: " << std::endl;
+        lifecycle_trace::event("2 Car constructor called: ");
         snprintf(number_plate, sizeof(number_plate) - 1, "%s:%d", new_number_plate, counter);
         counter++;
         // strncpy(new_number_plate, "abc", sizeof(new_number_plate) - 1);
@@ -26,7 +27,7 @@ public:
 
     ~Car()
     {
-        std::cout << "Car destructor called: " << std::endl;
+        lifecycle_trace::event("Car destructor called: ");
     }
 
     void set_number_plate(const char *new_number_plate)
@@ -1,60 +1,51 @@
 #pragma once
 
 #include <iostream>
-#include <string.h>
+#include "number_plate.h"
+#include "lifecycle_trace.h"
 
 class Car
 {
 private:
-    char *number_plate = nullptr;
+    NumberPlate number_plate;
 
 public:
     Car() : Car("")
     {
-        std::cout << "Car constructor called: " << std::endl;
+        lifecycle_trace::event("Car constructor called: ");
     }
 
     Car(const char *new_number_plate)
     {
-        std::cout << "Car delegating constructor called: " << std::endl;
+        lifecycle_trace::event("Car delegating constructor called: ");
 
         set_number_plate(new_number_plate);
     }
 
-    Car(const Car &other)
+    Car(const Car &other) : number_plate(other.number_plate)
     {
-        std::cout << "Copy constructor called: " << std::endl;
-
-        set_number_plate(other.number_plate);
+        lifecycle_trace::event("Copy constructor called: ");
     }
 
-    Car(Car &&other) noexcept
+    Car(Car &&other) noexcept : number_plate(std::move(other.number_plate))
     {
-        std::cout << "Move constructor called: " << std::endl;
-        number_plate = std::move(other.number_plate);
-        other.number_plate = nullptr;
+        lifecycle_trace::event("Move constructor called: ");
     }
 
     // Car(Car &&other) noexcept = default;
 
     ~Car()
     {
-        std::cout << "Car destructor called: " << std::endl;
-        delete[] number_plate;
-        number_plate = nullptr;
+        lifecycle_trace::event("Car destructor called: ");
     }
 
     void set_number_plate(const char *new_number_plate)
     {
-        delete[] number_plate;
-        size_t input_length = strlen(new_number_plate);
-        number_plate = new char[input_length + 1];
-        strncpy(number_plate, new_number_plate, input_length);
-        number_plate[input_length] = '\0';
+        number_plate.assign(new_number_plate);
     }
 
     const char *get_number_plate() const
     {
-        return number_plate;
+        return number_plate.c_str();
     }
 };
\ No newline at end of file
@@ -0,0 +1,455 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Constructor/destructor tracing for the exercise classes.
+//
+// Compile-time level: build with -DLIFECYCLE_TRACE_LEVEL=0 and every trace call
+// compiles to nothing. The default level 1 records events.
+//
+// Runtime mode when enabled:
+//   Immediate - each event is written to std::cout right away (the default, so the
+//               exercises print their output in program order).
+//   Buffered  - each thread puts its events into a ring buffer of its own and a
+//               background thread writes them out. Producers take no lock and
+//               share no counters. When a thread's buffer is full it waits for
+//               the writer (Overflow::Wait, the default) or drops the event and
+//               counts it (Overflow::Drop); dropped events are reported on
+//               std::cerr at exit. Events of one thread stay in order; events
+//               of different threads are written in batches.
+// The mode can be chosen with set_mode() or the LIFECYCLE_TRACE_MODE=buffered
+// environment variable.
+#ifndef LIFECYCLE_TRACE_LEVEL
+#define LIFECYCLE_TRACE_LEVEL 1
+#endif
+
+namespace lifecycle_trace
+{
+    constexpr int LEVEL = LIFECYCLE_TRACE_LEVEL;
+
+    enum class Mode
+    {
+        Immediate,
+        Buffered
+    };
+
+    // What a buffered producer does when its buffer is full.
+    enum class Overflow
+    {
+        Wait, // until the writer catches up, so no event is lost (the default)
+        Drop  // drop the event and count it
+    };
+
+    struct Event
+    {
+        const void *self;
+        const void *other;
+        const char *message; // must be a string literal
+    };
+
+    inline std::ostream &operator<<(std::ostream &os, const Event &event)
+    {
+        if (event.self != nullptr)
+        {
+            os << event.self;
+            if (event.other != nullptr)
+            {
+                os << " < " << event.other;
+            }
+            os << ": ";
+        }
+        return os << event.message;
+    }
+
+    // Appends "0x..." (as operator<< prints a pointer) to out.
+    inline char *format_pointer(char *out, const void *pointer)
+    {
+        uintptr_t value = reinterpret_cast<uintptr_t>(pointer);
+        char digits[2 * sizeof(uintptr_t)];
+        size_t count = 0;
+        do
+        {
+            digits[count++] = "0123456789abcdef"[value & 0xf];
+            value >>= 4;
+        } while (value != 0);
+        *out++ = '0';
+        *out++ = 'x';
+        while (count > 0)
+        {
+            *out++ = digits[--count];
+        }
+        return out;
+    }
+
+    // Appends the event as operator<< prints it, plus a newline.
+    inline void format_event(std::string &out, const Event &event)
+    {
+        char line[64];
+        char *end = line;
+        if (event.self != nullptr)
+        {
+            end = format_pointer(end, event.self);
+            if (event.other != nullptr)
+            {
+                *end++ = ' ';
+                *end++ = '<';
+                *end++ = ' ';
+                end = format_pointer(end, event.other);
+            }
+            *end++ = ':';
+            *end++ = ' ';
+        }
+        out.append(line, static_cast<size_t>(end - line));
+        out.append(event.message);
+        out.push_back('\n');
+    }
+
+    // The events of one thread: a ring with a single producer (that thread)
+    // and a single consumer (the writer), so recording is a plain store and
+    // one release store, with nothing shared between threads.
+    class ThreadBuffer
+    {
+    private:
+        // At 20M events/s a thread fills 2K slots in the 100 us the writer
+        // may sleep; 16K leaves room for slow output.
+        static constexpr size_t CAPACITY = 1 << 14;
+        static constexpr size_t MASK = CAPACITY - 1;
+
+        std::unique_ptr<Event[]> events{new Event[CAPACITY]};
+        alignas(64) std::atomic<size_t> write_position{0};
+        std::atomic<size_t> dropped{0}; // written by the producer only
+        alignas(64) std::atomic<size_t> read_position{0};
+
+    public:
+        std::atomic<bool> released{false}; // its thread has exited
+
+        bool try_push(const Event &event)
+        {
+            size_t position = write_position.load(std::memory_order_relaxed);
+            if (position - read_position.load(std::memory_order_acquire) == CAPACITY)
+            {
+                return false; // full
+            }
+            events[position & MASK] = event;
+            write_position.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        void count_dropped()
+        {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        // Consumer only: formats every event pushed so far into out.
+        size_t drain(std::string &out)
+        {
+            size_t begin = read_position.load(std::memory_order_relaxed);
+            size_t end = write_position.load(std::memory_order_acquire);
+            for (size_t position = begin; position != end; ++position)
+            {
+                format_event(out, events[position & MASK]);
+            }
+            read_position.store(end, std::memory_order_release);
+            return end - begin;
+        }
+
+        size_t get_written() const
+        {
+            return write_position.load(std::memory_order_acquire);
+        }
+
+        size_t get_read() const
+        {
+            return read_position.load(std::memory_order_acquire);
+        }
+
+        size_t get_dropped() const
+        {
+            return dropped.load(std::memory_order_relaxed);
+        }
+
+        bool is_drained() const
+        {
+            return get_read() == get_written();
+        }
+    };
+
+    class Tracer
+    {
+    private:
+        std::atomic<Mode> mode{Mode::Immediate};
+        std::atomic<Overflow> overflow{Overflow::Wait};
+        std::atomic<bool> running{false};
+        std::atomic<bool> stopped{false}; // shut down at exit; later events are dropped
+        std::mutex mutex;                 // guards buffers and writer
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::thread writer;
+
+        Tracer()
+        {
+            const char *env = std::getenv("LIFECYCLE_TRACE_MODE");
+            if (env != nullptr && std::strcmp(env, "buffered") == 0)
+            {
+                set_mode(Mode::Buffered);
+            }
+            std::atexit([]()
+                        { instance().shutdown(); });
+        }
+
+        // Gives the thread a buffer of its own, reusing one whose thread has
+        // exited and whose events have all been written.
+        ThreadBuffer *register_thread()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (std::unique_ptr<ThreadBuffer> &buffer : buffers)
+            {
+                if (buffer->released.load(std::memory_order_acquire) && buffer->is_drained())
+                {
+                    buffer->released.store(false, std::memory_order_relaxed);
+                    return buffer.get();
+                }
+            }
+            buffers.emplace_back(new ThreadBuffer());
+            return buffers.back().get();
+        }
+
+        ThreadBuffer &thread_buffer()
+        {
+            struct Registration
+            {
+                ThreadBuffer *buffer = nullptr;
+
+                ~Registration()
+                {
+                    if (buffer != nullptr)
+                    {
+                        buffer->released.store(true, std::memory_order_release);
+                        buffer = nullptr; // a late event at exit registers again
+                    }
+                }
+            };
+            thread_local Registration registration;
+            if (registration.buffer == nullptr)
+            {
+                registration.buffer = register_thread();
+            }
+            return *registration.buffer;
+        }
+
+        std::vector<ThreadBuffer *> snapshot()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<ThreadBuffer *> result;
+            for (std::unique_ptr<ThreadBuffer> &buffer : buffers)
+            {
+                result.push_back(buffer.get());
+            }
+            return result;
+        }
+
+        void start_writer()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running.load(std::memory_order_relaxed) && !stopped.load(std::memory_order_relaxed))
+            {
+                running.store(true, std::memory_order_release);
+                writer = std::thread(&Tracer::write_loop, this);
+            }
+        }
+
+        void write_loop()
+        {
+            const size_t OUTPUT_CHUNK = 1 << 20;
+            std::string output;
+            output.reserve(OUTPUT_CHUNK + 4096);
+            while (true)
+            {
+                size_t count = 0;
+                for (ThreadBuffer *buffer : snapshot())
+                {
+                    count += buffer->drain(output);
+                    if (output.size() >= OUTPUT_CHUNK)
+                    {
+                        std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+                        output.clear();
+                    }
+                }
+                if (count > 0)
+                {
+                    std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+                    std::cout.flush();
+                    output.clear();
+                    continue;
+                }
+                if (!running.load(std::memory_order_acquire))
+                {
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+
+        // Writes out what is buffered and stops the writer. The tracer itself
+        // is never destroyed, so threads still tracing during exit are safe;
+        // their events are counted as dropped.
+        void shutdown()
+        {
+            flush();
+            stopped.store(true, std::memory_order_release);
+            running.store(false, std::memory_order_release);
+            if (writer.joinable())
+            {
+                writer.join();
+            }
+            size_t lost = get_dropped();
+            if (lost > 0)
+            {
+                std::cerr << "lifecycle_trace: " << lost << " events were dropped" << std::endl;
+            }
+        }
+
+    public:
+        Tracer(const Tracer &) = delete;
+        Tracer &operator=(const Tracer &) = delete;
+
+        // Created on first use and intentionally never destroyed.
+        static Tracer &instance()
+        {
+            static Tracer *tracer = new Tracer();
+            return *tracer;
+        }
+
+        void set_mode(Mode new_mode)
+        {
+            if (new_mode == Mode::Buffered)
+            {
+                start_writer();
+            }
+            else
+            {
+                flush();
+            }
+            mode.store(new_mode, std::memory_order_release);
+        }
+
+        void set_overflow(Overflow new_overflow)
+        {
+            overflow.store(new_overflow, std::memory_order_relaxed);
+        }
+
+        void record(const Event &event)
+        {
+            if (mode.load(std::memory_order_relaxed) == Mode::Immediate)
+            {
+                std::cout << event << '\n';
+                return;
+            }
+            ThreadBuffer &buffer = thread_buffer();
+            if (stopped.load(std::memory_order_acquire))
+            {
+                buffer.count_dropped(); // nothing writes the buffers any more
+                return;
+            }
+            while (!buffer.try_push(event))
+            {
+                if (overflow.load(std::memory_order_relaxed) == Overflow::Drop ||
+                    stopped.load(std::memory_order_acquire))
+                {
+                    buffer.count_dropped();
+                    return;
+                }
+                std::this_thread::yield(); // the writer is behind; wait for it
+            }
+        }
+
+        // Waits until every event recorded so far has been written.
+        void flush()
+        {
+            for (ThreadBuffer *buffer : snapshot())
+            {
+                size_t target = buffer->get_written();
+                while (running.load(std::memory_order_acquire) && buffer->get_read() < target)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+        }
+
+        size_t get_dropped()
+        {
+            size_t total = 0;
+            for (ThreadBuffer *buffer : snapshot())
+            {
+                total += buffer->get_dropped();
+            }
+            return total;
+        }
+
+        size_t get_recorded()
+        {
+            size_t total = 0;
+            for (ThreadBuffer *buffer : snapshot())
+            {
+                total += buffer->get_written();
+            }
+            return total;
+        }
+    };
+
+    inline void event(const void *self, const char *message)
+    {
+        if constexpr (LEVEL > 0)
+        {
+            Tracer::instance().record(Event{self, nullptr, message});
+        }
+    }
+
+    inline void event(const void *self, const void *other, const char *message)
+    {
+        if constexpr (LEVEL > 0)
+        {
+            Tracer::instance().record(Event{self, other, message});
+        }
+    }
+
+    // Event without an object address.
+    inline void event(const char *message)
+    {
+        event(nullptr, message);
+    }
+
+    inline void set_mode(Mode mode)
+    {
+        if constexpr (LEVEL > 0)
+        {
+            Tracer::instance().set_mode(mode);
+        }
+    }
+
+    inline void set_overflow(Overflow overflow)
+    {
+        if constexpr (LEVEL > 0)
+        {
+            Tracer::instance().set_overflow(overflow);
+        }
+    }
+
+    inline void flush()
+    {
+        if constexpr (LEVEL > 0)
+        {
+            Tracer::instance().flush();
+        }
+    }
+}
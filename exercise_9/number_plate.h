@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+// Number plate stored inline for up to INLINE_CAPACITY characters, so creating,
+// copying or moving a car with a normal plate never touches the heap. Longer
+// plates fall back to a heap buffer. The text is always null-terminated.
+class NumberPlate
+{
+public:
+    static constexpr size_t INLINE_CAPACITY = 23;
+
+private:
+    union
+    {
+        char buffer[INLINE_CAPACITY + 1];
+        char *heap;
+    };
+    size_t length = 0;
+
+    bool on_heap() const
+    {
+        return length > INLINE_CAPACITY;
+    }
+
+    char *data()
+    {
+        return on_heap() ? heap : buffer;
+    }
+
+    void release()
+    {
+        if (on_heap())
+        {
+            delete[] heap;
+        }
+        length = 0;
+        buffer[0] = '\0';
+    }
+
+public:
+    NumberPlate() : buffer{}
+    {
+    }
+
+    NumberPlate(const char *text) : NumberPlate(std::string_view(text))
+    {
+    }
+
+    NumberPlate(std::string_view text) : buffer{}
+    {
+        assign(text);
+    }
+
+    NumberPlate(const NumberPlate &other) : NumberPlate(other.view())
+    {
+    }
+
+    NumberPlate(NumberPlate &&other) noexcept : length(other.length)
+    {
+        std::memcpy(buffer, other.buffer, sizeof(buffer));
+        other.length = 0;
+        other.buffer[0] = '\0';
+    }
+
+    NumberPlate &operator=(const NumberPlate &other)
+    {
+        if (this != &other)
+        {
+            assign(other.view());
+        }
+        return *this;
+    }
+
+    NumberPlate &operator=(NumberPlate &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            std::memcpy(buffer, other.buffer, sizeof(buffer));
+            length = other.length;
+            other.length = 0;
+            other.buffer[0] = '\0';
+        }
+        return *this;
+    }
+
+    ~NumberPlate()
+    {
+        release();
+    }
+
+    void assign(std::string_view text)
+    {
+        size_t size = text.size();
+        if (size > INLINE_CAPACITY && size <= length)
+        {
+            // The current heap buffer is large enough, reuse it.
+            std::memmove(heap, text.data(), size);
+            heap[size] = '\0';
+            length = size;
+            return;
+        }
+
+        // text may point into the old heap buffer, so free it last.
+        char *old_heap = on_heap() ? heap : nullptr;
+        if (size > INLINE_CAPACITY)
+        {
+            char *allocated = new char[size + 1];
+            std::memcpy(allocated, text.data(), size);
+            allocated[size] = '\0';
+            heap = allocated;
+        }
+        else
+        {
+            std::memmove(buffer, text.data(), size);
+            buffer[size] = '\0';
+        }
+        length = size;
+        delete[] old_heap;
+    }
+
+    const char *c_str() const
+    {
+        return on_heap() ? heap : buffer;
+    }
+
+    std::string_view view() const
+    {
+        return std::string_view(c_str(), length);
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+
+    bool empty() const
+    {
+        return length == 0;
+    }
+
+    bool is_inline() const
+    {
+        return !on_heap();
+    }
+
+    friend bool operator==(const NumberPlate &a, const NumberPlate &b)
+    {
+        return a.view() == b.view();
+    }
+
+    friend bool operator!=(const NumberPlate &a, const NumberPlate &b)
+    {
+        return !(a == b);
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const NumberPlate &plate)
+    {
+        return os << plate.view();
+    }
+};
+
+namespace std
+{
+    template <>
+    struct hash<NumberPlate>
+    {
+        size_t operator()(const NumberPlate &plate) const noexcept
+        {
+            return hash<string_view>()(plate.view());
+        }
+    };
+}
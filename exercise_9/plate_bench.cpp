@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <utility>
+#include "car.h"
+
+// Counts every global allocation made by this program.
+static size_t allocation_count = 0;
+
+// Once these are inlined, GCC sees free() releasing memory from new[] and warns
+// (-Wmismatched-new-delete), although malloc() is what allocated it.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(size_t size)
+{
+    ++allocation_count;
+    if (void *memory = std::malloc(size ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+// The array and sized forms forward to the plain one, as operator new[] does.
+void operator delete[](void *memory) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+    operator delete(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// The previous Car: a heap char * plate, without the logging.
+class HeapPlateCar
+{
+private:
+    char *number_plate = nullptr;
+
+public:
+    HeapPlateCar(const char *new_number_plate)
+    {
+        set_number_plate(new_number_plate);
+    }
+
+    HeapPlateCar(const HeapPlateCar &other)
+    {
+        set_number_plate(other.number_plate);
+    }
+
+    HeapPlateCar(HeapPlateCar &&other) noexcept : number_plate(other.number_plate)
+    {
+        other.number_plate = nullptr;
+    }
+
+    ~HeapPlateCar()
+    {
+        delete[] number_plate;
+    }
+
+    void set_number_plate(const char *new_number_plate)
+    {
+        delete[] number_plate;
+        size_t input_length = strlen(new_number_plate);
+        number_plate = new char[input_length + 1];
+        memcpy(number_plate, new_number_plate, input_length + 1);
+    }
+};
+
+template <typename CarType>
+void run(const char *name, const char *plate, int iterations)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    size_t before = allocation_count;
+    Clock::time_point start = Clock::now();
+
+    CarType original(plate);
+    for (int i = 0; i < iterations; ++i)
+    {
+        CarType copy(original);
+        CarType moved(std::move(copy));
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    size_t allocations = allocation_count - before;
+
+    std::cout << name << " \"" << plate << "\": " << allocations << " allocations, " << ms << " ms" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const char *short_plate = "LH 1234";
+    const char *long_plate = "DIPLOMATIC-CORPS-LH-0000001";
+
+    std::cout << iterations << " copies + moves per run" << std::endl;
+
+    run<HeapPlateCar>("before (char *)   ", short_plate, iterations);
+    run<Car>("after (NumberPlate)", short_plate, iterations);
+    run<HeapPlateCar>("before (char *)   ", long_plate, iterations);
+    run<Car>("after (NumberPlate)", long_plate, iterations);
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "car.h"
+
+// Measures how fast Car lifecycle events can be recorded in buffered mode,
+// from one or more threads. The trace goes to stdout; redirect it, e.g.
+// ./trace_bench > /dev/null
+//
+// Usage: trace_bench [cars per thread] [threads] [drop]
+//   drop - drop events when a thread's buffer is full instead of waiting
+int main(int argc, char *argv[])
+{
+    typedef std::chrono::steady_clock Clock;
+
+    int cars = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 1;
+    bool drop = argc > 3 && std::string(argv[3]) == "drop";
+
+    lifecycle_trace::set_mode(lifecycle_trace::Mode::Buffered);
+    lifecycle_trace::set_overflow(drop ? lifecycle_trace::Overflow::Drop : lifecycle_trace::Overflow::Wait);
+
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([cars]()
+                             {
+                                 for (int i = 0; i < cars; ++i)
+                                 {
+                                     Car car{"LH 1234"};
+                                     Car copy{car};
+                                 } });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    double record_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    lifecycle_trace::flush();
+    double total_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    lifecycle_trace::Tracer &tracer = lifecycle_trace::Tracer::instance();
+    size_t dropped = tracer.get_dropped();
+    std::cerr << tracer.get_recorded() << " events recorded in " << record_seconds << " s ("
+              << tracer.get_recorded() / record_seconds << " events/s), "
+              << dropped << " dropped, written out after " << total_seconds << " s" << std::endl;
+    if (dropped > 0)
+    {
+        std::cerr << "WARNING: " << dropped << " of " << tracer.get_recorded() + dropped
+                  << " events were dropped" << std::endl;
+    }
+
+    return 0;
+}